@@ -0,0 +1,426 @@
+/**
+ * Microbenchmark for every Fraction operator: construction, reduce(), the four
+ * arithmetic operators against fractions and floats, comparisons, ++/-- and stream I/O.
+ * Each operation runs over several operand distributions, and the results are printed
+ * and written as JSON (bench.json by default) so releases can be compared.
+ *
+ * Build and run with: make bench            (make bench BENCH_JSON=out.json)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+#include "sources/BigFraction.hpp"
+#include "sources/Fraction.hpp"
+#include "sources/FractionFormat.hpp"
+#include "sources/FractionHashMap.hpp"
+#include "sources/FractionPool.hpp"
+#include "sources/FractionSort.hpp"
+
+using namespace ariel;
+
+namespace
+{
+    const size_t SAMPLES = 1 << 16;
+    const int ROUNDS = 5;
+
+    // Operand magnitudes: numerators and denominators are uniform in [1, limit], the
+    // numerator with a random sign
+    struct Distribution
+    {
+        const char *name;
+        int limit;
+    };
+
+    const Distribution DISTRIBUTIONS[] = {
+        {"small", 100},
+        {"medium", 10000},
+        {"large", 1 << 20},
+        {"full", 2147483647},
+    };
+
+    struct Result
+    {
+        string operation;
+        string operands;
+        string distribution;
+        size_t samples;
+        double nanos;
+    };
+
+    vector<Result> results;
+    volatile int64_t sink;
+
+    // Best-of-ROUNDS nanoseconds per call of body over count samples
+    template <typename Body>
+    double timePerCall(size_t count, Body body)
+    {
+        double best = 1e300;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            auto start = chrono::steady_clock::now();
+            body();
+            auto stop = chrono::steady_clock::now();
+            best = min(best, chrono::duration<double, nano>(stop - start).count() / static_cast<double>(count));
+        }
+        return best;
+    }
+
+    void record(const string &operation, const string &operands, const Distribution &dist, size_t samples, double nanos)
+    {
+        results.push_back({operation, operands, dist.name, samples, nanos});
+        cout << setw(14) << operation << setw(20) << operands << setw(8) << dist.name << setw(9) << samples
+             << setw(10) << fixed << setprecision(2) << nanos << '\n';
+    }
+
+    int randomMagnitude(mt19937 &rng, const Distribution &dist)
+    {
+        return static_cast<int>(rng() % static_cast<unsigned>(dist.limit)) + 1;
+    }
+
+    int randomSigned(mt19937 &rng, const Distribution &dist)
+    {
+        int value = randomMagnitude(rng, dist);
+        return (rng() & 1) != 0 ? -value : value;
+    }
+
+    vector<Fraction> randomFractions(mt19937 &rng, const Distribution &dist)
+    {
+        vector<Fraction> values;
+        values.reserve(SAMPLES);
+        for (size_t i = 0; i < SAMPLES; ++i)
+        {
+            values.emplace_back(randomSigned(rng, dist), randomMagnitude(rng, dist));
+        }
+        return values;
+    }
+
+    // The pairs for which op does not throw, so the timed loop never unwinds
+    template <typename Lhs, typename Rhs, typename Op>
+    void keepValid(vector<Lhs> &lhs, vector<Rhs> &rhs, Op op)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < lhs.size(); ++i)
+        {
+            try
+            {
+                op(lhs[i], rhs[i]);
+            }
+            catch (const exception &)
+            {
+                continue;
+            }
+            lhs[kept] = lhs[i];
+            rhs[kept] = rhs[i];
+            ++kept;
+        }
+        lhs.resize(kept);
+        rhs.resize(kept);
+    }
+
+    // ++ and -- add the denominator to the numerator unchecked, and keepValid cannot
+    // catch an overflow that never throws: they only get values where |num| + den fits
+    vector<Fraction> steppable(const vector<Fraction> &values)
+    {
+        vector<Fraction> kept;
+        for (const Fraction &frac : values)
+        {
+            if (abs(int64_t(frac.getNumerator())) + frac.getDenominator() <= numeric_limits<int>::max())
+            {
+                kept.push_back(frac);
+            }
+        }
+        return kept;
+    }
+
+    template <typename Lhs, typename Rhs, typename Op>
+    void benchBinary(const string &operation, const string &operands, const Distribution &dist, vector<Lhs> lhs, vector<Rhs> rhs, Op op)
+    {
+        keepValid(lhs, rhs, op);
+        // e.g. fraction-fraction arithmetic on full-range operands, which always overflows
+        if (lhs.empty())
+        {
+            return;
+        }
+        double nanos = timePerCall(lhs.size(), [&]
+                                   {
+            int64_t acc = 0;
+            for (size_t i = 0; i < lhs.size(); ++i)
+            {
+                acc += static_cast<int64_t>(op(lhs[i], rhs[i]));
+            }
+            sink = acc; });
+        record(operation, operands, dist, lhs.size(), nanos);
+    }
+
+    // What a result contributes to the checksum that keeps the loops alive
+    int64_t digest(const Fraction &frac) { return frac.getNumerator() ^ frac.getDenominator(); }
+
+    // std::sort over a copy of values, ns per element
+    template <typename Value>
+    void benchSort(const string &operands, const Distribution &dist, const vector<Value> &values)
+    {
+        double nanos = timePerCall(values.size(), [&]
+                                   {
+            vector<Value> sorted = values;
+            sort(sorted.begin(), sorted.end());
+            sink = sorted.front() < sorted.back(); });
+        record("sort", operands, dist, values.size(), nanos);
+    }
+
+    // Fractions also get the keyed radix sort, on one thread per core
+    template <typename Int>
+    void benchSort(const string &operands, const Distribution &dist, const vector<BasicFraction<Int>> &values)
+    {
+        benchSort<BasicFraction<Int>>(operands, dist, values);
+        double nanos = timePerCall(values.size(), [&]
+                                   {
+            vector<BasicFraction<Int>> sorted = values;
+            sortFractions<Int>(sorted);
+            sink = sorted.front() < sorted.back(); });
+        record("sortFractions", operands, dist, values.size(), nanos);
+    }
+
+    template <typename Map>
+    void benchGroupBy(const string &operands, const Distribution &dist, const vector<Fraction> &values)
+    {
+        double nanos = timePerCall(values.size(), [&]
+                                   {
+            Map counts;
+            for (const Fraction &frac : values)
+            {
+                ++counts[frac];
+            }
+            sink = static_cast<int64_t>(counts.size()); });
+        record("group-by", operands, dist, values.size(), nanos);
+    }
+
+    void benchDistribution(const Distribution &dist, mt19937 &rng)
+    {
+        vector<int> nums(SAMPLES), dens(SAMPLES);
+        for (size_t i = 0; i < SAMPLES; ++i)
+        {
+            nums[i] = randomSigned(rng, dist);
+            dens[i] = randomMagnitude(rng, dist);
+        }
+        benchBinary("construct", "int-int", dist, nums, dens, [](int num, int den)
+                    { return digest(Fraction(num, den)); });
+
+        vector<Fraction> lhs = randomFractions(rng, dist);
+        vector<Fraction> rhs = randomFractions(rng, dist);
+        benchBinary("reduce", "reduced fraction", dist, lhs, rhs, [](Fraction frac, const Fraction &)
+                    {
+            frac.reduce();
+            return digest(frac); });
+
+        benchBinary("+", "fraction-fraction", dist, lhs, rhs, [](const Fraction &a, const Fraction &b)
+                    { return digest(a + b); });
+        benchBinary("-", "fraction-fraction", dist, lhs, rhs, [](const Fraction &a, const Fraction &b)
+                    { return digest(a - b); });
+        benchBinary("*", "fraction-fraction", dist, lhs, rhs, [](const Fraction &a, const Fraction &b)
+                    { return digest(a * b); });
+        benchBinary("/", "fraction-fraction", dist, lhs, rhs, [](const Fraction &a, const Fraction &b)
+                    { return digest(a / b); });
+
+        // Floats with three decimals, the precision the float overloads keep
+        vector<float> floats(SAMPLES);
+        for (float &value : floats)
+        {
+            value = static_cast<float>(randomSigned(rng, dist)) / 1000.0F;
+        }
+        benchBinary("+", "fraction-float", dist, lhs, floats, [](const Fraction &a, float b)
+                    { return digest(a + b); });
+        benchBinary("-", "fraction-float", dist, lhs, floats, [](const Fraction &a, float b)
+                    { return digest(a - b); });
+        benchBinary("*", "fraction-float", dist, lhs, floats, [](const Fraction &a, float b)
+                    { return digest(a * b); });
+        benchBinary("/", "fraction-float", dist, lhs, floats, [](const Fraction &a, float b)
+                    { return digest(a / b); });
+
+        benchBinary("==", "fraction-fraction", dist, lhs, rhs, [](const Fraction &a, const Fraction &b)
+                    { return a == b; });
+        benchBinary("<", "fraction-fraction", dist, lhs, rhs, [](const Fraction &a, const Fraction &b)
+                    { return a < b; });
+        benchBinary("==", "fraction-float", dist, lhs, floats, [](const Fraction &a, float b)
+                    { return a == b; });
+        vector<Fraction> steps = steppable(lhs);
+        benchBinary("++", "fraction", dist, steps, steps, [](Fraction frac, const Fraction &)
+                    { return digest(++frac); });
+        benchBinary("--", "fraction", dist, steps, steps, [](Fraction frac, const Fraction &)
+                    { return digest(--frac); });
+
+        // Stream I/O reuses one stream per loop, as a reader or writer of a file would
+        double nanos = timePerCall(lhs.size(), [&]
+                                   {
+            ostringstream out;
+            for (const Fraction &frac : lhs)
+            {
+                out << frac << '\n';
+            }
+            sink = static_cast<int64_t>(out.tellp()); });
+        record("<<", "ostream", dist, lhs.size(), nanos);
+
+        string text;
+        for (const Fraction &frac : lhs)
+        {
+            text += to_string(frac.getNumerator()) + ' ' + to_string(frac.getDenominator()) + '\n';
+        }
+        nanos = timePerCall(lhs.size(), [&]
+                            {
+            istringstream in(text);
+            Fraction frac;
+            int64_t acc = 0;
+            for (size_t i = 0; i < lhs.size(); ++i)
+            {
+                in >> frac;
+                acc += digest(frac);
+            }
+            sink = acc; });
+        record(">>", "istream", dist, lhs.size(), nanos);
+
+        // The allocation-free formatter and parser, for comparison with the streams
+        vector<char> buffer(lhs.size() * MAX_FRACTION_CHARS<int>);
+        nanos = timePerCall(lhs.size(), [&]
+                            { sink = toChars(buffer.data(), buffer.data() + buffer.size(), lhs.data(), lhs.data() + lhs.size()).ptr - buffer.data(); });
+        record("toChars", "buffer", dist, lhs.size(), nanos);
+        nanos = timePerCall(lhs.size(), [&]
+                            {
+            const char *pos = text.data();
+            const char *last = text.data() + text.size();
+            Fraction frac;
+            int64_t acc = 0;
+            while (pos != last)
+            {
+                pos = fromChars(pos, last, frac).ptr + 1;
+                acc += digest(frac);
+            }
+            sink = acc; });
+        record("fromChars", "buffer", dist, lhs.size(), nanos);
+
+        benchSort("fraction", dist, lhs);
+
+        // Group-by count, the dedup pattern: one lookup or insert per value
+        benchGroupBy<FractionHashMap<int>>("FractionHashMap", dist, lhs);
+        benchGroupBy<unordered_map<Fraction, int>>("unordered_map", dist, lhs);
+    }
+
+    // Comparisons where the exact path is expensive: Fraction128 beyond 64-bit operands
+    // and multi-limb BigFraction. Sorting copies of the same data shows the effect on an
+    // ordering-heavy workload (ns per element).
+    template <typename Value>
+    void benchOrdering(const string &operands, const Distribution &dist, const vector<Value> &values)
+    {
+        vector<Value> shifted(values.begin() + 1, values.end());
+        shifted.push_back(values.front());
+        benchBinary("<", operands, dist, values, shifted, [](const Value &a, const Value &b)
+                    { return a < b; });
+        benchSort(operands, dist, values);
+    }
+
+    void benchWideOrdering(mt19937 &rng)
+    {
+        const Distribution wide{"wide", 0};
+        auto random128 = [&rng](int bits)
+        {
+            unsigned __int128 raw = (static_cast<unsigned __int128>(rng()) << 96) | (static_cast<unsigned __int128>(rng()) << 64) |
+                                    (static_cast<unsigned __int128>(rng()) << 32) | rng();
+            return static_cast<__int128>(raw >> (128 - bits)) + 1;
+        };
+        vector<Fraction128> fractions;
+        vector<BigFraction> bigs;
+        for (size_t i = 0; i < SAMPLES / 4; ++i)
+        {
+            __int128 num = (i & 1) != 0 ? -random128(100) : random128(100);
+            fractions.emplace_back(num, random128(100));
+            bigs.emplace_back(BigInteger(num) * BigInteger(random128(100)), BigInteger(random128(120)) * BigInteger(random128(100)));
+        }
+        benchOrdering("fraction128", wide, fractions);
+        benchOrdering("bigfraction", wide, bigs);
+    }
+
+    // Rows drawn from a few thousand distinct rates, the case the pool is for: plain
+    // operators on the fractions against memoized operations on their ids
+    void benchInterning(mt19937 &rng)
+    {
+        const Distribution repeated{"rates", DISTRIBUTIONS[1].limit};
+        vector<Fraction> rates = randomFractions(rng, repeated);
+        rates.resize(2000);
+        vector<Fraction> lhs(SAMPLES), rhs(SAMPLES);
+        for (size_t i = 0; i < SAMPLES; ++i)
+        {
+            lhs[i] = rates[rng() % rates.size()];
+            rhs[i] = rates[rng() % rates.size()];
+        }
+        benchBinary("*", "fraction-fraction", repeated, lhs, rhs, [](const Fraction &a, const Fraction &b)
+                    { return digest(a * b); });
+        benchBinary("+", "fraction-fraction", repeated, lhs, rhs, [](const Fraction &a, const Fraction &b)
+                    { return digest(a + b); });
+
+        FractionPool pool;
+        vector<FractionPool::Id> lhs_ids(SAMPLES), rhs_ids(SAMPLES);
+        for (size_t i = 0; i < SAMPLES; ++i)
+        {
+            lhs_ids[i] = pool.intern(lhs[i]);
+            rhs_ids[i] = pool.intern(rhs[i]);
+        }
+        benchBinary("intern", "fraction", repeated, lhs, rhs, [&pool](const Fraction &a, const Fraction &)
+                    { return pool.intern(a); });
+        // The first round fills the memo; best-of-rounds reports the warm lookups
+        benchBinary("*", "pool ids", repeated, lhs_ids, rhs_ids, [&pool](FractionPool::Id a, FractionPool::Id b)
+                    { return pool.multiply(a, b); });
+        benchBinary("+", "pool ids", repeated, lhs_ids, rhs_ids, [&pool](FractionPool::Id a, FractionPool::Id b)
+                    { return pool.add(a, b); });
+        benchBinary("value", "pool id", repeated, lhs_ids, rhs_ids, [&pool](FractionPool::Id a, FractionPool::Id)
+                    { return digest(pool.value(a)); });
+    }
+
+    void writeJson(const string &path)
+    {
+        ofstream out(path);
+        out << "{\n  \"benchmark\": \"fraction_operators\",\n";
+        out << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+        out << "  \"rounds\": " << ROUNDS << ",\n  \"unit\": \"ns_per_op\",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result &result = results[i];
+            out << "    {\"operation\": \"" << result.operation << "\", \"operands\": \"" << result.operands
+                << "\", \"distribution\": \"" << result.distribution << "\", \"samples\": " << result.samples
+                << ", \"ns_per_op\": " << fixed << setprecision(3) << result.nanos << '}' << (i + 1 < results.size() ? "," : "") << '\n';
+        }
+        out << "  ]\n}\n";
+        if (!out)
+        {
+            cerr << "Cannot write " << path << '\n';
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    string json = argc > 1 ? argv[1] : "bench.json";
+    mt19937 rng(20230520);
+
+    cout << "Fraction operators, best of " << ROUNDS << " rounds, ns per op\n";
+    cout << setw(14) << "operation" << setw(20) << "operands" << setw(8) << "dist" << setw(9) << "samples" << setw(10) << "ns" << '\n';
+    for (const Distribution &dist : DISTRIBUTIONS)
+    {
+        benchDistribution(dist, rng);
+    }
+    benchWideOrdering(rng);
+    benchInterning(rng);
+    writeJson(json);
+    cout << "\nResults written to " << json << '\n';
+    return 0;
+}
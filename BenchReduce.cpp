@@ -0,0 +1,162 @@
+/**
+ * Microbenchmark for Fraction::reduce() and the GCD kernels behind it.
+ * Times every kernel over operands of growing magnitude.
+ *
+ * Build and run with: make bench_reduce
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace std;
+
+#include "sources/Fraction.hpp"
+#include "sources/FractionArray.hpp"
+#include "sources/Gcd.hpp"
+
+using namespace ariel;
+
+namespace
+{
+    const size_t SAMPLES = 1 << 18;
+    const int ROUNDS = 5;
+
+    template <typename Unsigned>
+    vector<Unsigned> randomOperands(int bits, mt19937_64 &rng)
+    {
+        vector<Unsigned> values(SAMPLES);
+        Unsigned mask = bits >= static_cast<int>(sizeof(Unsigned) * 8) ? ~Unsigned(0) : static_cast<Unsigned>((Unsigned(1) << bits) - 1);
+        for (Unsigned &value : values)
+        {
+            auto random = static_cast<Unsigned>(rng());
+            if constexpr (sizeof(Unsigned) > sizeof(uint64_t))
+            {
+                random = (random << 64) | static_cast<Unsigned>(rng());
+            }
+            // Force the top bit so every operand really has the requested magnitude
+            value = static_cast<Unsigned>((random & mask) | (Unsigned(1) << (bits - 1)));
+        }
+        return values;
+    }
+
+    // Best-of-ROUNDS nanoseconds per call
+    template <typename Body>
+    double timePerCall(Body body)
+    {
+        double best = 1e300;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            auto start = chrono::steady_clock::now();
+            body();
+            auto stop = chrono::steady_clock::now();
+            best = min(best, chrono::duration<double, nano>(stop - start).count() / SAMPLES);
+        }
+        return best;
+    }
+
+    volatile uint64_t sink;
+
+    template <typename Unsigned>
+    void benchKernels(const char *width, int bits, mt19937_64 &rng)
+    {
+        vector<Unsigned> lhs = randomOperands<Unsigned>(bits, rng);
+        vector<Unsigned> rhs = randomOperands<Unsigned>(bits, rng);
+        cout << setw(8) << width << setw(6) << bits;
+        for (GcdKernel kernel : {GcdKernel::Euclid, GcdKernel::Stein, GcdKernel::Lehmer})
+        {
+            double nanos = timePerCall([&]
+                                       {
+                Unsigned acc = 0;
+                for (size_t i = 0; i < SAMPLES; ++i)
+                {
+                    acc ^= kernelGcd(kernel, lhs[i], rhs[i]);
+                }
+                sink = static_cast<uint64_t>(acc); });
+            cout << setw(10) << fixed << setprecision(2) << nanos;
+        }
+        cout << '\n';
+    }
+
+    template <typename Int>
+    void benchReduce(const char *name, int bits, mt19937_64 &rng)
+    {
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+        vector<Unsigned> nums = randomOperands<Unsigned>(bits, rng);
+        vector<Unsigned> dens = randomOperands<Unsigned>(bits, rng);
+        double nanos = timePerCall([&]
+                                   {
+            Int acc = 0;
+            for (size_t i = 0; i < SAMPLES; ++i)
+            {
+                BasicFraction<Int> frac(static_cast<Int>(nums[i]), static_cast<Int>(dens[i]));
+                acc ^= frac.getDenominator();
+            }
+            sink = static_cast<uint64_t>(acc); });
+        cout << setw(12) << name << setw(6) << bits << setw(10) << fixed << setprecision(2) << nanos << '\n';
+    }
+
+    // reduceBatch() over whole columns against the constructor loop above
+    void benchBatch(int bits, mt19937_64 &rng)
+    {
+        vector<uint32_t> nums = randomOperands<uint32_t>(bits, rng);
+        vector<uint32_t> dens = randomOperands<uint32_t>(bits, rng);
+        cout << setw(12) << "batch" << setw(6) << bits;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2})
+        {
+            setSimdLevel(level);
+            vector<int> out_num(SAMPLES), out_den(SAMPLES);
+            double nanos = timePerCall([&]
+                                       {
+                for (size_t i = 0; i < SAMPLES; ++i)
+                {
+                    out_num[i] = static_cast<int>(nums[i] >> 1);
+                    out_den[i] = static_cast<int>(dens[i] >> 1) | 1;
+                }
+                reduceBatch(out_num.data(), out_den.data(), SAMPLES);
+                sink = static_cast<uint64_t>(out_den[SAMPLES / 2]); });
+            cout << setw(10) << fixed << setprecision(2) << nanos;
+        }
+        cout << '\n';
+    }
+}
+
+int main()
+{
+    mt19937_64 rng(20230301);
+
+    cout << "gcd kernels, ns per call\n";
+    cout << setw(8) << "width" << setw(6) << "bits" << setw(10) << "euclid" << setw(10) << "stein" << setw(10) << "lehmer" << '\n';
+    for (int bits : {4, 8, 16, 24, 31})
+    {
+        benchKernels<uint32_t>("u32", bits, rng);
+    }
+    for (int bits : {32, 48, 63})
+    {
+        benchKernels<uint64_t>("u64", bits, rng);
+    }
+    for (int bits : {64, 96, 127})
+    {
+        benchKernels<unsigned __int128>("u128", bits, rng);
+    }
+
+    cout << "\nreduce() through the constructor, ns per call\n";
+    cout << setw(12) << "backend" << setw(6) << "bits" << setw(10) << "ns" << '\n';
+    for (int bits : {8, 16, 31})
+    {
+        benchReduce<int>("Fraction", bits, rng);
+    }
+    for (int bits : {32, 63})
+    {
+        benchReduce<int64_t>("Fraction64", bits, rng);
+    }
+
+    cout << "\nreduceBatch() per element, ns (scalar, avx2 if the CPU has it)\n";
+    for (int bits : {8, 16, 31})
+    {
+        benchBatch(bits, rng);
+    }
+    return 0;
+}
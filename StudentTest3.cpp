@@ -0,0 +1,1415 @@
+#include "doctest.h"
+#include <stdexcept>
+#include <limits>
+#include <sstream>
+#include "sources/Fraction.hpp"
+#include "sources/BigFraction.hpp"
+#include "sources/Gcd.hpp"
+#include "sources/LazyFraction.hpp"
+#include "sources/FractionArray.hpp"
+#include "sources/OverflowPolicy.hpp"
+#include "sources/StaticFraction.hpp"
+#include "sources/FractionFormat.hpp"
+#include "sources/FractionLoader.hpp"
+#include "sources/FractionWire.hpp"
+#include "sources/FractionSort.hpp"
+#include "sources/FractionHashMap.hpp"
+#include "sources/FractionPool.hpp"
+#include "sources/Parallel.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+using namespace ariel;
+using namespace std;
+
+TEST_SUITE("Wider integer backends") {
+    TEST_CASE("int64_t backend keeps denominators past the int range") {
+        Fraction64 a(1, 50000), b(1, 70000);
+        Fraction64 c = a * b; // 1/3500000000 does not fit in int
+        CHECK_EQ(c.getNumerator(), 1);
+        CHECK_EQ(c.getDenominator(), 3500000000LL);
+        CHECK_EQ(a + b, Fraction64(12, 350000));
+        CHECK_LT(b, a);
+        CHECK_THROWS_AS(Fraction64(1, 0), std::invalid_argument);
+    }
+
+    TEST_CASE("__int128 backend detects overflow without a wider type") {
+        Fraction128 big(FractionTraits<__int128>::max(), 1);
+        CHECK_THROWS_AS(big * big, std::overflow_error);
+        CHECK_THROWS_AS(big + big, std::overflow_error);
+        CHECK_NOTHROW(big - big);
+        CHECK_EQ(big / big, Fraction128(1, 1));
+    }
+
+    TEST_CASE("Stream operators on the wider backends") {
+        std::stringstream ss("-170141183460469231731687303715884105727 -3");
+        Fraction128 frac;
+        ss >> frac;
+        std::ostringstream os;
+        os << frac;
+        CHECK_EQ(os.str(), "170141183460469231731687303715884105727/3");
+
+        std::stringstream ss64("6 -4");
+        Fraction64 frac64;
+        ss64 >> frac64;
+        CHECK_EQ(frac64, Fraction64(-3, 2));
+    }
+}
+
+TEST_SUITE("BigFraction") {
+    TEST_CASE("Arithmetic that overflows Fraction stays exact") {
+        int max_int = std::numeric_limits<int>::max();
+        BigFraction f1(max_int, 1);
+        BigFraction f4(max_int - 100, max_int);
+        CHECK_NOTHROW(f1 * f4);
+        CHECK_EQ(f1 * f4, BigFraction(max_int - 100, 1));
+        CHECK_EQ(f1 + f1, BigFraction(2LL * max_int, 1));
+
+        BigFraction product(1);
+        for (int i = 0; i < 40; ++i)
+        {
+            product *= BigFraction(1LL << 40, 3);
+        }
+        CHECK_FALSE(product.getNumerator().isSmall());
+        for (int i = 0; i < 40; ++i)
+        {
+            product /= BigFraction(1LL << 40, 3);
+        }
+        CHECK_EQ(product, BigFraction(1));
+        CHECK(product.getNumerator().isSmall());
+    }
+
+    TEST_CASE("Harmonic sum stays exact over many terms") {
+        BigFraction sum;
+        for (long long k = 1; k <= 60; ++k)
+        {
+            sum += BigFraction(1, k);
+        }
+        std::ostringstream os;
+        os << sum;
+        CHECK_EQ(os.str(), "15117092380124150817026911/3230237388259077233637600");
+        CHECK(sum > BigFraction(4));
+        CHECK(sum < BigFraction(5));
+        CHECK(sum.toDouble() == doctest::Approx(4.679870412951738));
+    }
+
+    TEST_CASE("Same operator surface as Fraction") {
+        BigFraction a(1, 2), b(Fraction(1, 4));
+        CHECK_EQ(a + b, BigFraction(3, 4));
+        CHECK_EQ(a - 0.25, BigFraction(1, 4));
+        CHECK_EQ(0.4 * a, BigFraction(1, 5));
+        CHECK_EQ(a / b, BigFraction(2));
+        CHECK(a == 0.5);
+        CHECK(b < a);
+        CHECK(a >= b);
+        CHECK_THROWS_AS(a / 0, std::runtime_error);
+        CHECK_THROWS_AS(BigFraction(1, 0), std::invalid_argument);
+        CHECK_EQ(++a, BigFraction(3, 2));
+        CHECK_EQ(a--, BigFraction(3, 2));
+        CHECK_EQ(a, BigFraction(1, 2));
+
+        std::stringstream ss("-123456789012345678901234567890 -10");
+        BigFraction big;
+        ss >> big;
+        std::ostringstream os;
+        os << big;
+        CHECK_EQ(os.str(), "12345678901234567890123456789/1");
+
+        std::stringstream bad("7");
+        CHECK_THROWS_AS(bad >> big, std::runtime_error);
+    }
+}
+
+TEST_SUITE("GCD kernels") {
+    TEST_CASE("Euclid, Stein and Lehmer agree with std::gcd") {
+        std::mt19937_64 rng(7);
+        for (int i = 0; i < 2000; ++i)
+        {
+            uint64_t lhs = rng() >> (rng() % 64);
+            uint64_t rhs = rng() >> (rng() % 64);
+            uint64_t expected = std::gcd(lhs, rhs);
+            CHECK_EQ(euclidGcd(lhs, rhs), expected);
+            CHECK_EQ(steinGcd(lhs, rhs), expected);
+            CHECK_EQ(lehmerGcd(lhs, rhs), expected);
+            auto small_lhs = static_cast<uint32_t>(lhs);
+            auto small_rhs = static_cast<uint32_t>(rhs);
+            CHECK_EQ(kernelGcd(GcdKernel::Lehmer, small_lhs, small_rhs), std::gcd(small_lhs, small_rhs));
+        }
+        unsigned __int128 wide = static_cast<unsigned __int128>(1) << 100;
+        CHECK(steinGcd(wide * 3, wide * 5) == wide);
+        CHECK(lehmerGcd(wide * 3, wide * 5) == wide);
+        CHECK_EQ(steinGcd(0U, 12U), 12U);
+        CHECK_EQ(lehmerGcd(12U, 0U), 12U);
+    }
+}
+
+TEST_SUITE("LazyFraction") {
+    TEST_CASE("Accumulation defers reduce() until the value is observed") {
+        LazyFraction sum;
+        Fraction eager;
+        for (int k = 1; k <= 12; ++k)
+        {
+            sum += Fraction(k, 16);
+            eager = eager + Fraction(k, 16);
+        }
+        CHECK_FALSE(sum.isNormalized());
+        CHECK_EQ(sum.getNumerator(), eager.getNumerator());
+        CHECK(sum.isNormalized());
+        CHECK_EQ(sum.getDenominator(), eager.getDenominator());
+    }
+
+    TEST_CASE("Overflow risk reduces and retries before throwing") {
+        LazyFraction product(1);
+        for (int i = 0; i < 40; ++i)
+        {
+            product *= LazyFraction(6, 4);
+            product /= LazyFraction(3, 2);
+        }
+        CHECK_EQ(product.toFraction(), Fraction(1));
+
+        int max_int = std::numeric_limits<int>::max();
+        CHECK_THROWS_AS(LazyFraction(max_int) + LazyFraction(max_int), std::overflow_error);
+        CHECK_THROWS_AS(LazyFraction(1) / LazyFraction(0, 3), std::runtime_error);
+        CHECK_THROWS_AS(LazyFraction(1, 0), std::invalid_argument);
+    }
+
+    TEST_CASE("Comparisons and output observe the reduced value") {
+        LazyFraction a(2, 4), b(3, -9);
+        CHECK(b < a);
+        CHECK(a == LazyFraction(Fraction(1, 2)));
+        CHECK(a - b > LazyFraction(4, 5));
+        std::ostringstream os;
+        os << (a - b);
+        CHECK_EQ(os.str(), "5/6");
+    }
+
+    TEST_CASE("Const observers leave the value untouched, so threads can share it") {
+        const LazyFraction shared = LazyFraction(1, 6) + LazyFraction(1, 3);
+        std::array<Fraction, 2> seen;
+        std::array<bool, 2> less{};
+        std::thread other([&]
+                          { seen[1] = shared.toFraction(); less[1] = shared < LazyFraction(1); });
+        seen[0] = shared.toFraction();
+        less[0] = shared < LazyFraction(1);
+        other.join();
+        CHECK_EQ(seen[0], Fraction(1, 2));
+        CHECK_EQ(seen[1], Fraction(1, 2));
+        CHECK(less[0]);
+        CHECK(less[1]);
+        CHECK_FALSE(shared.isNormalized());
+    }
+}
+
+TEST_SUITE("Cross-reduction in operator* and operator/") {
+    TEST_CASE("Products that fit after cancelling no longer overflow") {
+        int max_int = std::numeric_limits<int>::max();
+        Fraction big(max_int - 1, 3);
+        Fraction scale(3, max_int - 1);
+        CHECK_EQ(big * scale, Fraction(1));
+        CHECK_EQ(big / big, Fraction(1));
+        CHECK_EQ(Fraction(-6, 35) * Fraction(14, 9), Fraction(-4, 15));
+        CHECK_EQ(Fraction(-6, 35) / Fraction(-9, 14), Fraction(4, 15));
+        CHECK_EQ(Fraction(0, 5) * big, Fraction(0));
+        CHECK_EQ(Fraction(0, 5) / big, Fraction(0));
+        CHECK_EQ(Fraction(std::numeric_limits<int>::min(), 1) * Fraction(1, 2), Fraction(std::numeric_limits<int>::min() / 2, 1));
+        CHECK_THROWS_AS(big * big, std::overflow_error);
+    }
+}
+
+TEST_SUITE("Henrici addition in operator+ and operator-") {
+    TEST_CASE("Sums are reduced and keep intermediates small") {
+        CHECK_EQ(Fraction(1, 6) + Fraction(1, 10), Fraction(4, 15));
+        CHECK_EQ(Fraction(1, 6) - Fraction(1, 10), Fraction(1, 15));
+        CHECK_EQ(Fraction(1, 4) + Fraction(3, 4), Fraction(1));
+        CHECK_EQ(Fraction(3, 8) - Fraction(3, 8), Fraction(0));
+        CHECK_EQ(Fraction(-5, 12) + Fraction(7, 18), Fraction(-1, 36));
+
+        // b*d = 46350^2 overflows int, but the shared factor keeps the sum in range
+        int den = 46350;
+        Fraction a(1, den), b(7, den);
+        CHECK_EQ(a + b, Fraction(8, den));
+        CHECK_EQ(Fraction(1, 2 * den) + Fraction(1, 3 * den), Fraction(5, 6 * den));
+
+        int max_int = std::numeric_limits<int>::max();
+        CHECK_THROWS_AS(Fraction(max_int) + Fraction(1), std::overflow_error);
+        CHECK_EQ(Fraction(max_int - 1, max_int) + Fraction(1, max_int), Fraction(1));
+    }
+
+    TEST_CASE("Matches the plain cross-multiplied sum") {
+        std::mt19937 rng(11);
+        for (int i = 0; i < 500; ++i)
+        {
+            auto num_a = static_cast<int>(rng() % 2001) - 1000;
+            auto num_b = static_cast<int>(rng() % 2001) - 1000;
+            auto den_a = static_cast<int>(rng() % 720) + 1;
+            auto den_b = static_cast<int>(rng() % 720) + 1;
+            Fraction plus = Fraction(num_a, den_a) + Fraction(num_b, den_b);
+            Fraction minus = Fraction(num_a, den_a) - Fraction(num_b, den_b);
+            CHECK_EQ(plus, Fraction(num_a * den_b + num_b * den_a, den_a * den_b));
+            CHECK_EQ(minus, Fraction(num_a * den_b - num_b * den_a, den_a * den_b));
+        }
+    }
+}
+
+namespace
+{
+    std::vector<Fraction> randomFractions(std::mt19937 &rng, size_t count, int range)
+    {
+        std::vector<Fraction> values;
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Spans computed in 64 bits: 2 * range + 1 overflows int for range == INT_MAX
+            auto num = static_cast<int>(static_cast<int64_t>(rng() % (2 * static_cast<uint64_t>(range) + 1)) - range);
+            auto den = static_cast<int>(rng() % static_cast<uint64_t>(range)) + 1;
+            values.emplace_back(num, den);
+        }
+        return values;
+    }
+}
+
+TEST_SUITE("FractionArray") {
+    TEST_CASE("Batch operators match the scalar operators on every SIMD level") {
+        std::mt19937 rng(3);
+        const size_t count = 37; // not a multiple of any vector width, so the tails run too
+        std::vector<Fraction> lhs = randomFractions(rng, count, 5000);
+        std::vector<Fraction> rhs = randomFractions(rng, count, 5000);
+        rhs[5] = Fraction(0);
+        rhs[9] = lhs[9];
+        FractionArray left(lhs), right(rhs);
+
+        SimdLevel original = simdLevel();
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2})
+        {
+            setSimdLevel(level);
+            FractionArray sum = left + right;
+            FractionArray diff = left - right;
+            FractionArray prod = left * right;
+            FractionArray::Mask less = left < right;
+            FractionArray::Mask equal = left == right;
+            FractionArray::Mask greater_equal = left >= right;
+            for (size_t i = 0; i < count; ++i)
+            {
+                CHECK_EQ(sum[i], lhs[i] + rhs[i]);
+                CHECK_EQ(diff[i], lhs[i] - rhs[i]);
+                CHECK_EQ(prod[i], lhs[i] * rhs[i]);
+                CHECK_EQ(less[i] != 0, lhs[i] < rhs[i]);
+                CHECK_EQ(equal[i] != 0, lhs[i] == rhs[i]);
+                CHECK_EQ(greater_equal[i] != 0, lhs[i] >= rhs[i]);
+            }
+            CHECK_THROWS_AS(left / right, std::runtime_error);
+        }
+        setSimdLevel(original);
+    }
+
+    TEST_CASE("Lanes with wide products reduce like the others in the same vector") {
+        std::mt19937 rng(4);
+        const size_t count = 45;
+        std::vector<Fraction> lhs = randomFractions(rng, count, 5000);
+        std::vector<Fraction> rhs = randomFractions(rng, count, 5000);
+        std::vector<Fraction> wide = randomFractions(rng, count, std::numeric_limits<int>::max());
+        // Wide times its reciprocal: 64-bit cross products that reduce to 1
+        for (size_t i = 0; i < count; i += 3)
+        {
+            if (wide[i].getNumerator() != 0)
+            {
+                lhs[i] = wide[i];
+                rhs[i] = Fraction(wide[i].getDenominator(), wide[i].getNumerator());
+            }
+        }
+        FractionArray left(lhs), right(rhs);
+
+        SimdLevel original = simdLevel();
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2})
+        {
+            setSimdLevel(level);
+            FractionArray prod = left * right;
+            for (size_t i = 0; i < count; ++i)
+            {
+                CHECK_EQ(prod[i], lhs[i] * rhs[i]);
+            }
+        }
+        setSimdLevel(original);
+    }
+
+    TEST_CASE("Division, overflow and reduce") {
+        FractionArray lhs(std::vector<Fraction>{Fraction(1, 2), Fraction(-3, 4), Fraction(5, 6)});
+        FractionArray rhs(std::vector<Fraction>{Fraction(1, 4), Fraction(3, -8), Fraction(10, 3)});
+        FractionArray quot = lhs / rhs;
+        CHECK_EQ(quot[0], Fraction(2));
+        CHECK_EQ(quot[1], Fraction(2));
+        CHECK_EQ(quot[2], Fraction(1, 4));
+        CHECK_EQ(quot.toVector(), std::vector<Fraction>{Fraction(2), Fraction(2), Fraction(1, 4)});
+
+        int max_int = std::numeric_limits<int>::max();
+        FractionArray big(std::vector<Fraction>{Fraction(max_int), Fraction(max_int)});
+        CHECK_THROWS_AS(big + big, std::overflow_error);
+        CHECK_THROWS_AS(lhs + big, std::invalid_argument);
+
+        FractionArray raw(3);
+        raw.numerators()[0] = 6;
+        raw.denominators()[0] = -8;
+        raw.numerators()[1] = 0;
+        raw.denominators()[1] = 5;
+        raw.reduce();
+        CHECK_EQ(raw[0], Fraction(-3, 4));
+        CHECK_EQ(raw.numerators()[1], 0);
+        CHECK_EQ(raw.denominators()[1], 1);
+    }
+}
+
+TEST_SUITE("Batch GCD and reduce") {
+    TEST_CASE("reduceBatch matches the Fraction constructor on every SIMD level") {
+        std::mt19937 rng(8);
+        std::uniform_int_distribution<int> any(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+        std::uniform_int_distribution<int> small(-64, 64);
+        const size_t count = 301;
+        std::vector<int> nums(count), dens(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Mix full-range values with small ones that share plenty of factors
+            nums[i] = i % 3 == 0 ? any(rng) : small(rng) * 720;
+            dens[i] = i % 5 == 0 ? any(rng) : small(rng) * 1260;
+            if (dens[i] == 0 || (nums[i] == std::numeric_limits<int>::min() && dens[i] < 0))
+            {
+                dens[i] = 7;
+            }
+        }
+        nums[10] = std::numeric_limits<int>::min();
+        dens[10] = 1 << 20;
+        dens[11] = std::numeric_limits<int>::min();
+        nums[12] = 0;
+
+        SimdLevel original = simdLevel();
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2})
+        {
+            setSimdLevel(level);
+            std::vector<int> out_num = nums, out_den = dens;
+            reduceBatch(out_num.data(), out_den.data(), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                Fraction expected(nums[i], dens[i]);
+                CHECK_EQ(out_num[i], expected.getNumerator());
+                CHECK_EQ(out_den[i], expected.getDenominator());
+            }
+
+            std::vector<uint32_t> lhs(count), rhs(count), gcd(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                lhs[i] = static_cast<uint32_t>(nums[i]);
+                rhs[i] = static_cast<uint32_t>(dens[i]);
+            }
+            lhs[3] = 0;
+            rhs[4] = 0;
+            gcdBatch(lhs.data(), rhs.data(), gcd.data(), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                CHECK_EQ(gcd[i], euclidGcd(lhs[i], rhs[i]));
+            }
+        }
+        setSimdLevel(original);
+    }
+
+    TEST_CASE("reduceBatch throws like the constructor") {
+        SimdLevel original = simdLevel();
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2})
+        {
+            setSimdLevel(level);
+            std::vector<int> nums(16, 2), dens(16, 4);
+            dens[9] = 0;
+            CHECK_THROWS_AS(reduceBatch(nums.data(), dens.data(), nums.size()), std::invalid_argument);
+            dens[9] = -1;
+            nums[9] = std::numeric_limits<int>::min();
+            CHECK_THROWS_AS(reduceBatch(nums.data(), dens.data(), nums.size()), std::overflow_error);
+        }
+        setSimdLevel(original);
+    }
+}
+
+TEST_SUITE("Checked arithmetic") {
+    TEST_CASE("Checked results match the throwing operators") {
+        Fraction a(3, 4), b(-5, 6);
+        CHECK_EQ(checkedAdd(a, b).value(), a + b);
+        CHECK_EQ(checkedSubtract(a, b).value(), a - b);
+        CHECK_EQ(checkedMultiply(a, b).value(), a * b);
+        CHECK_EQ(checkedDivide(a, b).value(), a / b);
+        CHECK(checkedAdd(a, b).has_value());
+        CHECK_EQ(*Fraction::make(6, -8), Fraction(-3, 4));
+    }
+
+    TEST_CASE("Errors are returned instead of thrown") {
+        int max_int = std::numeric_limits<int>::max();
+        Fraction big(max_int);
+        Checked<Fraction> sum = checkedAdd(big, big);
+        CHECK_FALSE(sum);
+        CHECK_EQ(sum.error(), FractionError::Overflow);
+        CHECK_THROWS_AS(sum.value(), std::overflow_error);
+        CHECK_EQ(sum.value_or(Fraction(7)), Fraction(7));
+        CHECK_EQ(checkedMultiply(big, Fraction(2)).error(), FractionError::Overflow);
+        CHECK_EQ(checkedSubtract(Fraction(-max_int - 1), Fraction(1)).error(), FractionError::Overflow);
+        CHECK_EQ(checkedDivide(big, Fraction(0)).error(), FractionError::DivideByZero);
+        CHECK_THROWS_AS(checkedDivide(big, Fraction(0)).value(), std::runtime_error);
+        CHECK_EQ(Fraction::make(1, 0).error(), FractionError::ZeroDenominator);
+        CHECK_EQ(Fraction::make(std::numeric_limits<int>::min(), -1).error(), FractionError::Overflow);
+        CHECK_EQ(Fraction128::make(1, 0).error(), FractionError::ZeroDenominator);
+    }
+}
+
+TEST_SUITE("Overflow policies") {
+    const int max_int = std::numeric_limits<int>::max();
+    const int min_int = std::numeric_limits<int>::min();
+
+    TEST_CASE("Throw policy behaves like Fraction") {
+        PolicyFraction<ThrowOnOverflow> a(1, 3), b(1, 6), big(max_int);
+        CHECK_EQ((a + b).fraction(), Fraction(1, 2));
+        CHECK_THROWS_AS(big + big, std::overflow_error);
+        CHECK_THROWS_AS(a / PolicyFraction<ThrowOnOverflow>(0), std::runtime_error);
+    }
+
+    TEST_CASE("Saturate policy returns the nearest representable value") {
+        using Saturating = PolicyFraction<SaturateOnOverflow>;
+        Saturating big(max_int), small(min_int);
+        CHECK_EQ((big + big).fraction(), Fraction(max_int));
+        CHECK_EQ((small * big).fraction(), Fraction(min_int));
+        CHECK_EQ((small - Saturating(1)).fraction(), Fraction(min_int));
+        // 1/max * 1/max is below the smallest positive value, so it rounds to 0
+        Saturating tiny(1, max_int);
+        CHECK_EQ((tiny * tiny).fraction(), Fraction(0));
+
+        // In range but with too many digits: compare with a brute force over small bounds
+        Saturating lhs(max_int - 1, max_int), rhs(max_int - 2, max_int - 1);
+        Fraction nearest = (lhs * rhs).fraction();
+        BigFraction exact = BigFraction(lhs.fraction()) * BigFraction(rhs.fraction());
+        BigFraction error = BigFraction(nearest) - exact;
+        CHECK_LT(nearest, Fraction(1));
+        CHECK_LT(error < BigFraction(0) ? BigFraction(0) - error : error, BigFraction(BigInteger(1), BigInteger(max_int) * BigInteger(max_int)));
+        CHECK_EQ(nearestRepresentable<int>(BigFraction(BigInteger(355), BigInteger(113))), Fraction(355, 113));
+        CHECK_EQ(nearestRepresentable<int>(BigFraction(-7, 2)), Fraction(-7, 2));
+        CHECK_THROWS_AS(big / Saturating(0), std::runtime_error);
+    }
+
+    TEST_CASE("Promote policy computes in the wider type") {
+        PolicyFraction<PromoteOnOverflow> big(max_int);
+        Fraction64 sum = big + big;
+        CHECK_EQ(sum, Fraction64(2LL * max_int));
+        PolicyFraction<PromoteOnOverflow, int64_t> huge(std::numeric_limits<int64_t>::max());
+        Fraction128 product = huge * huge;
+        CHECK_EQ(product.getDenominator(), 1);
+        PolicyFraction<PromoteOnOverflow, __int128> widest(FractionTraits<__int128>::max());
+        BigFraction exact = widest + widest;
+        CHECK_EQ(exact, BigFraction(BigInteger(FractionTraits<__int128>::max()) * BigInteger(2), BigInteger(1)));
+    }
+
+    TEST_CASE("Sticky policy records the first error") {
+        using Sticky = PolicyFraction<StickyOverflow>;
+        StickyOverflow::clear();
+        Sticky acc(0), step(1, 7), big(max_int);
+        for (int i = 0; i < 7; ++i)
+        {
+            acc = acc + step;
+        }
+        CHECK_EQ(acc.fraction(), Fraction(1));
+        CHECK_EQ(StickyOverflow::status(), FractionError::None);
+        CHECK_EQ((big * big).fraction(), Fraction(0));
+        CHECK_EQ((big / Sticky(0)).fraction(), Fraction(0));
+        CHECK_EQ(StickyOverflow::status(), FractionError::Overflow);
+        StickyOverflow::clear();
+        CHECK_EQ(StickyOverflow::status(), FractionError::None);
+    }
+}
+
+TEST_SUITE("constexpr Fraction") {
+    // Unit-conversion ratios folded at compile time
+    constexpr std::array<Fraction, 3> INCH_RATIOS{Fraction(254, 100), Fraction(12 * 254, 100), Fraction(36, 1) * Fraction(254, 100)};
+
+    static_assert(Fraction(6, -8) == Fraction(-3, 4));
+    static_assert(Fraction(1, 3) + Fraction(1, 6) == Fraction(1, 2));
+    static_assert(Fraction(3, 4) - Fraction(5, 4) == Fraction(-1, 2));
+    static_assert(Fraction(2, 3) * Fraction(9, 4) == Fraction(3, 2));
+    static_assert(Fraction(2, 3) / Fraction(4, 9) == Fraction(3, 2));
+    static_assert(Fraction(1, 3) < Fraction(1, 2) && Fraction(-1, 2) <= Fraction(-1, 2));
+    static_assert(INCH_RATIOS[0] == Fraction(127, 50) && INCH_RATIOS[2].getNumerator() == 2286);
+    static_assert(Fraction64(1, 50000) * Fraction64(1, 70000) == Fraction64(1, 3500000000LL));
+    static_assert(Fraction128(FractionTraits<__int128>::max(), 2) / Fraction128(FractionTraits<__int128>::max()) == Fraction128(1, 2));
+    static_assert(!checkedAdd(Fraction(std::numeric_limits<int>::max()), Fraction(1)));
+    static_assert(Fraction::make(1, 0).error() == FractionError::ZeroDenominator);
+
+    TEST_CASE("Compile-time values match the runtime ones") {
+        int numerator = 254;
+        CHECK_EQ(INCH_RATIOS[1], Fraction(12 * numerator, 100));
+        constexpr Fraction third = Fraction(1, 3);
+        CHECK_EQ(third + third + third, Fraction(1));
+        Fraction counter(1, 2);
+        CHECK_EQ(++counter, Fraction(3, 2));
+    }
+}
+
+TEST_SUITE("StaticFraction") {
+    using Half = StaticFraction<1, 2>;
+    using Two = StaticFraction<2>;
+    using Eighth = StaticFraction<-7, -56>;
+
+    static_assert(Eighth::num == 1 && Eighth::den == 8);
+    static_assert(StaticFraction<3, -6>::num == -1 && StaticFraction<3, -6>::den == 2);
+    static_assert(Fraction(3, 4) * Two() == Fraction(3, 2));
+    static_assert(Fraction(3, 4) / Half() == Fraction(3, 2));
+    static_assert(Fraction(3, 4) + StaticFraction<1>() == Fraction(7, 4));
+
+    TEST_CASE("Operators match the generic ones") {
+        std::mt19937 rng(13);
+        for (const Fraction &frac : randomFractions(rng, 200, 100000))
+        {
+            CHECK_EQ(frac * Two(), frac * Fraction(2));
+            CHECK_EQ(Two() * frac, frac * Fraction(2));
+            CHECK_EQ(frac * Eighth(), frac * Fraction(1, 8));
+            CHECK_EQ(frac * StaticFraction<-3, 7>(), frac * Fraction(-3, 7));
+            CHECK_EQ(frac * StaticFraction<64, 9>(), frac * Fraction(64, 9));
+            CHECK_EQ(frac / StaticFraction<-4, 3>(), frac / Fraction(-4, 3));
+            CHECK_EQ(frac + StaticFraction<5>(), frac + Fraction(5));
+            CHECK_EQ(frac - StaticFraction<-5>(), frac - Fraction(-5));
+            CHECK_EQ(frac + StaticFraction<7, 8>(), frac + Fraction(7, 8));
+            CHECK_EQ(StaticFraction<1, 3>() - frac, Fraction(1, 3) - frac);
+            if (frac.getNumerator() != 0)
+            {
+                CHECK_EQ(Half() / frac, Fraction(1, 2) / frac);
+            }
+        }
+        Fraction64 wide(5, 6);
+        CHECK_EQ(wide * StaticFraction<3, 10>(), Fraction64(1, 4));
+        CHECK_EQ(Fraction(1, 3) == StaticFraction<2, 6>(), true);
+        CHECK_LT(Fraction(1, 3), Half());
+        Fraction converted = Half();
+        CHECK_EQ(converted, Fraction(1, 2));
+    }
+
+    TEST_CASE("Overflow is reported like the generic operators") {
+        int max_int = std::numeric_limits<int>::max();
+        CHECK_THROWS_AS(Fraction(max_int) * Two(), std::overflow_error);
+        CHECK_THROWS_AS(Fraction(max_int) + StaticFraction<1>(), std::overflow_error);
+        CHECK_THROWS_AS(Fraction(1, max_int) / StaticFraction<3>(), std::overflow_error);
+        // N*b overflows int on its own but the sum fits
+        CHECK_EQ(Fraction(-max_int, 2) + StaticFraction<1 << 30>(), Fraction(-max_int, 2) + Fraction(1 << 30));
+    }
+}
+
+TEST_SUITE("Exact double conversion") {
+    static_assert(Fraction::fromDouble(0.75) == Fraction(3, 4));
+    static_assert(Fraction::fromDouble(-0.0) == Fraction(0));
+
+    TEST_CASE("Values come out exact with power-of-two denominators") {
+        CHECK_EQ(Fraction::fromDouble(-2.5), Fraction(-5, 2));
+        CHECK_EQ(Fraction::fromDouble(1024.0), Fraction(1024));
+        CHECK_EQ(Fraction::fromDouble(-2147483648.0), Fraction(std::numeric_limits<int>::min()));
+        CHECK_EQ(Fraction::fromDouble(1.0 / 1073741824.0), Fraction(1, 1073741824));
+        // 0.1 is not 1/10 in binary
+        Fraction64 tenth = Fraction64::fromDouble(0.1);
+        CHECK_EQ(tenth.getNumerator(), 3602879701896397LL);
+        CHECK_EQ(tenth.getDenominator(), 36028797018963968LL);
+        CHECK_EQ(Fraction128::fromDouble(std::ldexp(1.0, -126)).getDenominator(), FractionTraits<__int128>::max() / 2 + 1);
+        CHECK_EQ(Fraction128::fromDouble(std::ldexp(3.0, 100)).getNumerator(), static_cast<__int128>(3) << 100);
+
+        std::mt19937_64 rng(14);
+        std::uniform_real_distribution<double> unit(-1.0, 1.0);
+        for (int i = 0; i < 1000; ++i)
+        {
+            double value = unit(rng);
+            Fraction128 exact = Fraction128::fromDouble(value);
+            CHECK_EQ(static_cast<double>(exact.getNumerator()) / static_cast<double>(exact.getDenominator()), value);
+            CHECK_EQ(exact.getDenominator() & (exact.getDenominator() - 1), 0);
+        }
+    }
+
+    TEST_CASE("Unrepresentable values are reported") {
+        CHECK_EQ(Fraction::checkedFromDouble(0.1).error(), FractionError::Overflow);
+        CHECK_EQ(Fraction::checkedFromDouble(2147483648.0).error(), FractionError::Overflow);
+        CHECK_EQ(Fraction::checkedFromDouble(std::ldexp(1.0, -31)).error(), FractionError::Overflow);
+        CHECK_EQ(Fraction128::checkedFromDouble(std::numeric_limits<double>::denorm_min()).error(), FractionError::Overflow);
+        CHECK_EQ(Fraction::checkedFromDouble(std::numeric_limits<double>::quiet_NaN()).error(), FractionError::NotFinite);
+        CHECK_THROWS_AS(Fraction64::fromDouble(std::numeric_limits<double>::infinity()), std::invalid_argument);
+        CHECK_THROWS_AS(Fraction::fromDouble(1e10), std::overflow_error);
+    }
+}
+
+TEST_SUITE("Best rational approximation") {
+    static_assert(Fraction::approximate(0.75, 10) == Fraction(3, 4));
+
+    TEST_CASE("Smallest denominators within the bound") {
+        CHECK_EQ(Fraction::approximate(0.333, 100), Fraction(1, 3));
+        CHECK_EQ(Fraction::approximate(0.333, 1000), Fraction(333, 1000));
+        CHECK_EQ(Fraction::approximate(M_PI, 10), Fraction(22, 7));
+        CHECK_EQ(Fraction::approximate(M_PI, 100), Fraction(311, 99));
+        CHECK_EQ(Fraction::approximate(M_PI, 1000), Fraction(355, 113));
+        CHECK_EQ(Fraction::approximate(-M_PI, 1000), Fraction(-355, 113));
+        CHECK_EQ(Fraction::approximate(2.5, 1), Fraction(2)); // tie: smaller denominator
+        CHECK_EQ(Fraction::approximate(1e-9, 1000), Fraction(0));
+        CHECK_EQ(Fraction64::approximate(0.1, 1000000000000LL), Fraction64(1, 10));
+        Fraction64 golden = Fraction64::approximate((1 + std::sqrt(5.0)) / 2, 1000000);
+        CHECK_EQ(golden, Fraction64(1346269, 832040));
+    }
+
+    TEST_CASE("Results are never worse than the fixed-scale constructor") {
+        std::mt19937_64 rng(15);
+        std::uniform_real_distribution<double> unit(-100.0, 100.0);
+        for (int i = 0; i < 500; ++i)
+        {
+            double value = unit(rng);
+            Fraction best = Fraction::approximate(value, FRACTION_SCALE);
+            Fraction scaled(value);
+            double best_error = std::abs(static_cast<double>(best.getNumerator()) / best.getDenominator() - value);
+            double scaled_error = std::abs(static_cast<double>(scaled.getNumerator()) / scaled.getDenominator() - value);
+            CHECK_LE(best_error, scaled_error);
+            CHECK_LE(best.getDenominator(), FRACTION_SCALE);
+        }
+    }
+
+    TEST_CASE("Invalid input") {
+        CHECK_THROWS_AS(Fraction::approximate(0.5, 0), std::invalid_argument);
+        CHECK_THROWS_AS(Fraction::approximate(std::numeric_limits<double>::quiet_NaN(), 10), std::invalid_argument);
+        CHECK_THROWS_AS(Fraction::approximate(1e12, 10), std::overflow_error);
+        CHECK_THROWS_AS(Fraction::approximate(3e9 + 0.5, 10), std::overflow_error);
+    }
+}
+
+TEST_SUITE("Fast formatter") {
+    template <typename Int>
+    std::string streamed(const BasicFraction<Int> &frac)
+    {
+        std::ostringstream out;
+        out << frac;
+        return out.str();
+    }
+
+    TEST_CASE("toChars matches operator<< on every backend") {
+        std::vector<Fraction> values{Fraction(0), Fraction(-3, 4), Fraction(std::numeric_limits<int>::min()),
+                                     Fraction(std::numeric_limits<int>::max(), 99), Fraction(1, std::numeric_limits<int>::max())};
+        std::mt19937 rng(16);
+        for (const Fraction &frac : randomFractions(rng, 200, std::numeric_limits<int>::max()))
+        {
+            values.push_back(frac);
+        }
+        char buffer[MAX_FRACTION_CHARS<int>];
+        for (const Fraction &frac : values)
+        {
+            std::to_chars_result result = toChars(buffer, buffer + sizeof(buffer), frac);
+            CHECK(result.ec == std::errc());
+            CHECK_EQ(std::string(buffer, result.ptr), streamed(frac));
+        }
+
+        char wide[MAX_FRACTION_CHARS<__int128>];
+        for (const Fraction128 &frac : {Fraction128(FractionTraits<__int128>::min()), Fraction128(1, FractionTraits<__int128>::max()),
+                                        Fraction128(static_cast<__int128>(10000000000000000000ULL), 3), Fraction128(-7, 10)})
+        {
+            std::to_chars_result result = toChars(wide, wide + sizeof(wide), frac);
+            CHECK_EQ(std::string(wide, result.ptr), streamed(frac));
+        }
+        Fraction64 mid(std::numeric_limits<int64_t>::min() + 1, 7);
+        char mid_buffer[MAX_FRACTION_CHARS<int64_t>];
+        CHECK_EQ(std::string(mid_buffer, toChars(mid_buffer, mid_buffer + sizeof(mid_buffer), mid).ptr), streamed(mid));
+    }
+
+    TEST_CASE("Short buffers and bulk output") {
+        char small[4];
+        std::to_chars_result result = toChars(small, small + sizeof(small), Fraction(-12, 5));
+        CHECK(result.ec == std::errc::value_too_large);
+        CHECK_EQ(result.ptr, small + sizeof(small));
+
+        std::vector<Fraction> values{Fraction(1, 2), Fraction(-7, 3), Fraction(5)};
+        char buffer[64];
+        result = toChars(buffer, buffer + sizeof(buffer), values.data(), values.data() + values.size(), ' ');
+        CHECK_EQ(std::string(buffer, result.ptr), "1/2 -7/3 5/1 ");
+        result = toChars(buffer, buffer + 8, values.data(), values.data() + values.size(), ' ');
+        CHECK(result.ec == std::errc::value_too_large);
+
+        std::vector<Fraction> many(20000, Fraction(-123456, 7));
+        std::ostringstream out;
+        writeFractions(out, many.data(), many.data() + many.size());
+        std::string expected;
+        for (size_t i = 0; i < many.size(); ++i)
+        {
+            expected += "-123456/7\n";
+        }
+        CHECK_EQ(out.str(), expected);
+    }
+}
+
+TEST_SUITE("Fast parser") {
+    template <typename Int>
+    BasicFraction<Int> parsed(const std::string &text)
+    {
+        BasicFraction<Int> frac;
+        std::from_chars_result result = fromChars(text.data(), text.data() + text.size(), frac);
+        CHECK(result.ec == std::errc());
+        CHECK_EQ(result.ptr, text.data() + text.size());
+        return frac;
+    }
+
+    TEST_CASE("fromChars agrees with operator>> and toChars") {
+        std::mt19937 rng(17);
+        // At most INT_MAX / 3, so the unreduced text below still holds int values
+        for (const Fraction &frac : randomFractions(rng, 2000, std::numeric_limits<int>::max() / 3))
+        {
+            std::string text = std::to_string(frac.getNumerator() * 3) + " " + std::to_string(frac.getDenominator() * -3);
+            Fraction streamed;
+            std::istringstream in(text);
+            in >> streamed;
+            CHECK_EQ(parsed<int>(text), streamed);
+
+            char buffer[MAX_FRACTION_CHARS<int>];
+            std::to_chars_result written = toChars(buffer, buffer + sizeof(buffer), frac);
+            CHECK_EQ(parsed<int>(std::string(buffer, written.ptr)), frac);
+        }
+        CHECK_EQ(parsed<int>("-2147483648/1"), Fraction(std::numeric_limits<int>::min()));
+        CHECK_EQ(parsed<int64_t>("9223372036854775807\t2"), Fraction64(std::numeric_limits<int64_t>::max(), 2));
+        CHECK_EQ(parsed<__int128>("-170141183460469231731687303715884105728/2"), Fraction128(FractionTraits<__int128>::min() / 2));
+        CHECK_EQ(parsed<int>("+6/-4"), Fraction(-3, 2));
+        CHECK_EQ(parsed<int>("42"), Fraction(42));
+    }
+
+    TEST_CASE("Digit runs of every length and terminator") {
+        // Exercises both the eight-byte fast path and the per-digit tail
+        for (int length = 1; length <= 19; ++length)
+        {
+            std::string digits = std::string("9081726354546372819").substr(0, static_cast<size_t>(length));
+            for (const char *terminator : {"", "\n", "x", ".", "\x80", "0123456789"})
+            {
+                std::string text = digits + terminator + "/1........";
+                int64_t expected = 0;
+                std::from_chars_result want = std::from_chars(text.data(), text.data() + text.size(), expected);
+                Fraction64 frac;
+                std::from_chars_result result = fromChars(text.data(), text.data() + text.size(), frac);
+                if (std::string(terminator) == "0123456789" && length > 9)
+                {
+                    CHECK(result.ec == std::errc::result_out_of_range);
+                    continue;
+                }
+                REQUIRE(want.ec == std::errc());
+                CHECK(result.ec == std::errc());
+                CHECK_EQ(frac.getNumerator(), expected);
+                CHECK_EQ(result.ptr, want.ptr + (*want.ptr == '/' ? 2 : 0));
+            }
+        }
+    }
+
+    TEST_CASE("Decimal text is exact") {
+        CHECK_EQ(parsed<int>("1.25"), Fraction(5, 4));
+        CHECK_EQ(parsed<int>("-0.125"), Fraction(-1, 8));
+        CHECK_EQ(parsed<int>(".5"), Fraction(1, 2));
+        CHECK_EQ(parsed<int>("3.000000000000"), Fraction(3));
+        CHECK_EQ(parsed<int>("0.333333333"), Fraction(333333333, 1000000000));
+        CHECK_EQ(parsed<int64_t>("3.14159265358979"), Fraction64(314159265358979, 100000000000000));
+
+        Fraction frac;
+        std::string text = "0.1234567891";
+        CHECK(fromChars(text.data(), text.data() + text.size(), frac).ec == std::errc::result_out_of_range);
+    }
+
+    TEST_CASE("Errors are reported without throwing") {
+        auto parse = [](const std::string &text, Fraction &frac) { return fromChars(text.data(), text.data() + text.size(), frac); };
+        Fraction frac(7, 9);
+        for (const std::string text : {"", "x", "-", " 1/2", "1/", "1/x", "1/0", "0 0", "."})
+        {
+            std::from_chars_result result = parse(text, frac);
+            CHECK(result.ec == std::errc::invalid_argument);
+            CHECK_EQ(result.ptr, text.data());
+        }
+        CHECK_EQ(frac, Fraction(7, 9));
+
+        std::string big = "2147483648/3,";
+        std::from_chars_result result = parse(big, frac);
+        CHECK(result.ec == std::errc::result_out_of_range);
+        CHECK_EQ(*result.ptr, ',');
+        CHECK(parse("-2147483648/-1", frac).ec == std::errc::result_out_of_range);
+        CHECK_EQ(frac, Fraction(7, 9));
+
+        // Only the leading fraction is consumed, so records can be walked in a buffer
+        std::string records = "1/2,3 4\n5 x";
+        const char *pos = records.data();
+        const char *end = records.data() + records.size();
+        std::vector<Fraction> values;
+        while (pos != end)
+        {
+            result = fromChars(pos, end, frac);
+            REQUIRE(result.ec == std::errc());
+            values.push_back(frac);
+            pos = result.ptr;
+            while (pos != end && (*pos == ',' || *pos == '\n' || *pos == ' ' || *pos == 'x'))
+            {
+                ++pos;
+            }
+        }
+        CHECK_EQ(values, std::vector<Fraction>{Fraction(1, 2), Fraction(3, 4), Fraction(5)});
+    }
+}
+
+TEST_SUITE("Bulk loader") {
+    std::string tempPath(const std::string &name)
+    {
+        return (std::filesystem::temp_directory_path() / ("fraction_loader_" + name)).string();
+    }
+
+    void writeFile(const std::string &path, const std::string &contents)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << contents;
+    }
+
+    TEST_CASE("Text files round trip on any number of threads") {
+        std::mt19937 rng(18);
+        std::vector<Fraction> values = randomFractions(rng, 50000, std::numeric_limits<int>::max());
+        std::string path = tempPath("text");
+        saveFractions(path, values.data(), values.data() + values.size());
+        for (unsigned threads : {0U, 1U, 3U, 8U})
+        {
+            CHECK_EQ(loadFractions<int>(path, FractionFileFormat::Text, threads), values);
+        }
+
+        writeFile(path, "1/2\n3 4\n  -1.5\r\n\n7 -14\t12/-8\n0.125");
+        std::vector<Fraction> mixed{Fraction(1, 2), Fraction(3, 4), Fraction(-3, 2), Fraction(-1, 2), Fraction(-3, 2), Fraction(1, 8)};
+        for (unsigned threads : {1U, 2U, 5U, 40U})
+        {
+            CHECK_EQ(loadFractions<int>(path, FractionFileFormat::Text, threads), mixed);
+        }
+        writeFile(path, "");
+        CHECK(loadFractions<int>(path, FractionFileFormat::Text, 4).empty());
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("Text errors name the first bad line") {
+        std::string path = tempPath("bad_text");
+        std::string lines;
+        for (int i = 0; i < 1000; ++i)
+        {
+            lines += "1/3\n";
+        }
+        writeFile(path, lines + "2/0\n" + lines + "1/2x\n");
+        for (unsigned threads : {1U, 4U})
+        {
+            CHECK_THROWS_WITH_AS(loadFractions<int>(path, FractionFileFormat::Text, threads), doctest::Contains("line 1001"), std::runtime_error);
+        }
+        writeFile(path, "1/2\n1/2x\n");
+        CHECK_THROWS_AS(loadFractions<int>(path, FractionFileFormat::Text, 2), std::runtime_error);
+        writeFile(path, "1/2\n2147483648/3\n");
+        CHECK_THROWS_AS(loadFractions<int>(path), std::overflow_error);
+        CHECK_EQ(loadFractions<int64_t>(path)[1], Fraction64(2147483648LL, 3));
+        std::filesystem::remove(path);
+        CHECK_THROWS_AS(loadFractions<int>(path), std::runtime_error);
+    }
+
+    TEST_CASE("A chunk that throws reaches the caller after every worker joined") {
+        for (unsigned failing : {0U, 2U})
+        {
+            std::vector<int> ran(4, 0);
+            auto body = [&ran, failing](unsigned chunk)
+            {
+                ran[chunk] = 1;
+                if (chunk >= failing)
+                {
+                    throw std::runtime_error("chunk " + std::to_string(chunk));
+                }
+            };
+            CHECK_THROWS_WITH_AS(detail::runChunks(4, body), ("chunk " + std::to_string(failing)).c_str(), std::runtime_error);
+            CHECK_EQ(std::count(ran.begin(), ran.end(), 1), 4);
+        }
+    }
+
+    TEST_CASE("Binary files round trip and convert between widths") {
+        std::mt19937 rng(81);
+        std::vector<Fraction> values = randomFractions(rng, 30000, std::numeric_limits<int>::max());
+        std::string path = tempPath("binary");
+        saveFractions(path, values.data(), values.data() + values.size(), FractionFileFormat::Binary);
+        CHECK_EQ(std::filesystem::file_size(path), BINARY_HEADER_SIZE + values.size() * 8);
+        for (unsigned threads : {0U, 1U, 7U})
+        {
+            CHECK_EQ(loadFractions<int>(path, FractionFileFormat::Binary, threads), values);
+        }
+        std::vector<Fraction128> wide = loadFractions<__int128>(path, FractionFileFormat::Binary, 2);
+        REQUIRE_EQ(wide.size(), values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            CHECK_EQ(wide[i], Fraction128(values[i]));
+        }
+
+        std::vector<Fraction64> large{Fraction64(-5, 10), Fraction64(std::numeric_limits<int64_t>::min(), 3)};
+        saveFractions(path, large.data(), large.data() + large.size(), FractionFileFormat::Binary);
+        CHECK_EQ(loadFractions<int64_t>(path, FractionFileFormat::Binary), large);
+        CHECK_EQ(loadFractions<__int128>(path, FractionFileFormat::Binary)[1], Fraction128(large[1]));
+        CHECK_THROWS_WITH_AS(loadFractions<int>(path, FractionFileFormat::Binary), doctest::Contains("record 1"), std::overflow_error);
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("Corrupt binary files") {
+        std::string path = tempPath("bad_binary");
+        std::string header("FRAC\x01\x04\0\0\x02\0\0\0\0\0\0\0", BINARY_HEADER_SIZE);
+        // Records are not reduced on disk, and a zero denominator is rejected
+        writeFile(path, header + std::string("\x06\0\0\0\xfc\xff\xff\xff\x01\0\0\0\0\0\0\0", 16));
+        CHECK_THROWS_WITH_AS(loadFractions<int>(path, FractionFileFormat::Binary), doctest::Contains("record 1"), std::runtime_error);
+        writeFile(path, header + std::string("\x06\0\0\0\xfc\xff\xff\xff\x01\0\0\0\x02\0\0\0", 16));
+        CHECK_EQ(loadFractions<int>(path, FractionFileFormat::Binary), std::vector<Fraction>{Fraction(-3, 2), Fraction(1, 2)});
+        writeFile(path, header + std::string(12, '\0'));
+        CHECK_THROWS_WITH_AS(loadFractions<int>(path, FractionFileFormat::Binary), doctest::Contains("Truncated"), std::runtime_error);
+        writeFile(path, "1/2\n");
+        CHECK_THROWS_WITH_AS(loadFractions<int>(path, FractionFileFormat::Binary), doctest::Contains("Not a binary"), std::runtime_error);
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_SUITE("Wire format") {
+    TEST_CASE("Round trips in both modes on every backend") {
+        std::mt19937 rng(19);
+        std::vector<Fraction> values = randomFractions(rng, 5000, std::numeric_limits<int>::max());
+        values.push_back(Fraction(std::numeric_limits<int>::min()));
+        values.push_back(Fraction(std::numeric_limits<int>::max(), std::numeric_limits<int>::max() - 1));
+        for (WireMode mode : {WireMode::Plain, WireMode::RunLength})
+        {
+            std::vector<uint8_t> bytes = encodeFractions<int>(values, mode);
+            CHECK_EQ(bytes.size(), encodedSize<int>(values, mode));
+            CHECK_EQ(decodedCount(bytes), values.size());
+            CHECK_EQ(decodeFractions<int>(bytes), values);
+        }
+
+        std::vector<Fraction128> wide{Fraction128(FractionTraits<__int128>::min()), Fraction128(-1, FractionTraits<__int128>::max()), Fraction128()};
+        CHECK_EQ(decodeFractions<__int128>(encodeFractions<__int128>(wide, WireMode::RunLength)), wide);
+        // The format does not depend on the width, so values that fit cross backends
+        std::vector<Fraction64> narrow = decodeFractions<int64_t>(encodeFractions<int>(values));
+        CHECK_EQ(narrow.back(), Fraction64(values.back()));
+        CHECK(encodeFractions<int>(std::vector<Fraction>{}) == std::vector<uint8_t>{'F', 'W', WIRE_VERSION, 0, 0});
+    }
+
+    TEST_CASE("Small values take a byte per field") {
+        // A fixed-scale column: the prime denominator survives reduction
+        std::vector<Fraction> column;
+        for (int i = -2000; i < 2000; ++i)
+        {
+            column.push_back(Fraction(i * 7, 1009));
+        }
+        std::ostringstream text;
+        writeFractions(text, column.data(), column.data() + column.size());
+
+        std::vector<uint8_t> bytes = encodeFractions<int>(std::vector<Fraction>{Fraction(-1, 2), Fraction(63, 127)});
+        CHECK(bytes == std::vector<uint8_t>{'F', 'W', 1, 0, 2, 1, 2, 126, 127});
+        CHECK_LT(encodedSize<int>(column) * 2, text.str().size());
+        CHECK_LT(encodedSize<int>(column, WireMode::RunLength) * 4, text.str().size());
+
+        std::vector<Fraction> same(1000, Fraction(3, 100));
+        CHECK_EQ(encodedSize<int>(same, WireMode::RunLength), 4 + 2 + 1 + 2 + 1000);
+    }
+
+    TEST_CASE("Encoding and decoding in place") {
+        std::vector<Fraction> values{Fraction(1, 3), Fraction(-5, 3), Fraction(7, 9)};
+        std::array<uint8_t, 64> buffer{};
+        size_t written = encodeFractions<int>(values, buffer, WireMode::RunLength);
+        std::array<Fraction, 3> decoded;
+        CHECK_EQ(decodeFractions<int>(std::span<const uint8_t>(buffer.data(), written), decoded), written);
+        CHECK_EQ(std::vector<Fraction>(decoded.begin(), decoded.end()), values);
+
+        std::array<uint8_t, 8> small{};
+        CHECK_THROWS_AS(encodeFractions<int>(values, small), std::length_error);
+        std::array<Fraction, 2> short_out;
+        CHECK_THROWS_AS(decodeFractions<int>(std::span<const uint8_t>(buffer.data(), written), short_out), std::length_error);
+    }
+
+    TEST_CASE("Malformed input") {
+        auto decode = [](std::vector<uint8_t> bytes) { return decodeFractions<int>(bytes); };
+        CHECK_THROWS_AS(decode({'F', 'X', 1, 0, 0}), std::runtime_error);
+        CHECK_THROWS_AS(decode({'F', 'W', 2, 0, 0}), std::runtime_error);
+        CHECK_THROWS_AS(decode({'F', 'W', 1, 0, 1, 2}), std::runtime_error);
+        // A count far beyond the payload is rejected before the result is allocated
+        CHECK_THROWS_AS(decode({'F', 'W', 1, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F}), std::runtime_error);
+        CHECK_THROWS_AS(decode({'F', 'W', 1, 1, 5, 2, 3, 2, 4}), std::runtime_error);
+        CHECK_THROWS_WITH_AS(decode({'F', 'W', 1, 0, 1, 2, 0}), "Zero denominator in fraction data", std::runtime_error);
+        CHECK_THROWS_AS(decode({'F', 'W', 1, 1, 2, 3, 3, 2, 4}), std::runtime_error);
+        CHECK_THROWS_AS(decode({'F', 'W', 1, 0, 1, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 1}), std::overflow_error);
+        CHECK_EQ(decode({'F', 'W', 1, 0, 1, 4, 6}), std::vector<Fraction>{Fraction(1, 3)});
+
+        std::vector<Fraction64> large{Fraction64(1, 5000000000LL)};
+        CHECK_THROWS_AS(decodeFractions<int>(encodeFractions<int64_t>(large)), std::overflow_error);
+    }
+}
+
+TEST_SUITE("Three-way comparison") {
+    static_assert((Fraction(1, 3) <=> Fraction(1, 2)) == std::strong_ordering::less);
+    static_assert((Fraction(-2, 4) <=> Fraction(-1, 2)) == std::strong_ordering::equal);
+    static_assert(Fraction(7, 3) >= Fraction(2) && Fraction(-1, 5) < Fraction());
+
+    // Exact cross products, independent of every comparison operator under test
+    std::strong_ordering expectedOrder(const BigFraction &lhs, const BigFraction &rhs)
+    {
+        BigInteger lhs_cross = lhs.getNumerator() * rhs.getDenominator();
+        BigInteger rhs_cross = rhs.getNumerator() * lhs.getDenominator();
+        return lhs_cross == rhs_cross ? std::strong_ordering::equal : lhs_cross < rhs_cross ? std::strong_ordering::less : std::strong_ordering::greater;
+    }
+
+    template <typename Int>
+    std::strong_ordering expectedOrder(const BasicFraction<Int> &lhs, const BasicFraction<Int> &rhs)
+    {
+        return expectedOrder(BigFraction(lhs), BigFraction(rhs));
+    }
+
+    TEST_CASE("Every pair of small fractions") {
+        std::vector<Fraction> values;
+        for (int num = -6; num <= 6; ++num)
+        {
+            for (int den = 1; den <= 6; ++den)
+            {
+                values.emplace_back(num, den);
+            }
+        }
+        for (const Fraction &lhs : values)
+        {
+            for (const Fraction &rhs : values)
+            {
+                std::strong_ordering order = lhs <=> rhs;
+                CHECK(order == expectedOrder(lhs, rhs));
+                CHECK_EQ(lhs < rhs, order < 0);
+                CHECK_EQ(lhs <= rhs, order <= 0);
+                CHECK_EQ(lhs > rhs, order > 0);
+                CHECK_EQ(lhs >= rhs, order >= 0);
+            }
+        }
+    }
+
+    TEST_CASE("Extreme operands never overflow") {
+        const int max_int = std::numeric_limits<int>::max();
+        CHECK_FALSE(Fraction(max_int, max_int - 1) > Fraction(max_int - 1, max_int - 2));
+        CHECK(Fraction(std::numeric_limits<int>::min(), max_int) < Fraction(-1));
+
+        // Fraction128 has no wider type; products that do not fit used to throw
+        const __int128 max = FractionTraits<__int128>::max();
+        std::mt19937_64 rng(21);
+        auto random128 = [&rng]()
+        { return static_cast<__int128>((static_cast<unsigned __int128>(rng()) << 64 | rng()) >> (1 + rng() % 100)); };
+        for (int i = 0; i < 2000; ++i)
+        {
+            __int128 den = random128() + 1;
+            Fraction128 lhs(random128() * ((i & 1) != 0 ? -1 : 1), den);
+            // Neighbours with equal integer parts force several continued-fraction steps
+            Fraction128 rhs = i % 3 == 0 ? Fraction128(random128(), random128() + 1) : Fraction128(lhs.getNumerator() + ((i & 2) != 0 ? 1 : -1), den + 1);
+            CHECK((lhs <=> rhs) == expectedOrder(lhs, rhs));
+            CHECK((rhs <=> lhs) == expectedOrder(rhs, lhs));
+        }
+        CHECK_FALSE(Fraction128(max, max - 1) > Fraction128(max - 1, max - 2));
+        CHECK(Fraction128(-max, max - 1) > Fraction128(-(max - 1), max - 2));
+        CHECK((Fraction128(max, 3) <=> Fraction128(max, 3)) == 0);
+    }
+
+    std::strong_ordering bigOrder(const BigFraction &lhs, const BigFraction &rhs)
+    {
+        return lhs < rhs ? std::strong_ordering::less : (lhs > rhs ? std::strong_ordering::greater : std::strong_ordering::equal);
+    }
+
+    // The double pre-check must hand every near tie to the exact path
+    TEST_CASE("Near ties fall back to the exact order") {
+        // Values that agree in far more bits than a double holds
+        BigInteger huge = BigInteger(1) << 300;
+        BigFraction base(huge + BigInteger(7), huge - BigInteger(3));
+        BigFraction above(huge + BigInteger(8), huge - BigInteger(3));
+        CHECK(bigOrder(base, above) == std::strong_ordering::less);
+        CHECK(bigOrder(above, base) == std::strong_ordering::greater);
+        CHECK(bigOrder(BigFraction(0) - above, BigFraction(0) - base) == std::strong_ordering::less);
+        CHECK(bigOrder(base, BigFraction(huge + BigInteger(7), huge - BigInteger(3))) == std::strong_ordering::equal);
+        CHECK(base <= above);
+        CHECK(above >= base);
+
+        const __int128 max = FractionTraits<__int128>::max();
+        CHECK(Fraction128(max - 1, max - 2) < Fraction128(max - 2, max - 3));
+        CHECK(Fraction128(-(max - 2), max - 3) < Fraction128(-(max - 1), max - 2));
+        CHECK(Fraction128(max / 3, max / 2) < Fraction128(max / 3 + 1, max / 2));
+    }
+
+    TEST_CASE("Magnitudes past the double range") {
+        BigInteger wide = BigInteger(1) << 2000;
+        BigFraction tiny(BigInteger(1), wide);
+        BigFraction large(wide, BigInteger(3));
+        CHECK(tiny < large);
+        CHECK(BigFraction(0) - large < BigFraction(0) - tiny);
+        CHECK(tiny > BigFraction(0));
+        CHECK(BigFraction(BigInteger(1), wide * BigInteger(2)) < tiny);
+
+        std::mt19937_64 rng(22);
+        for (int i = 0; i < 500; ++i)
+        {
+            BigFraction lhs(BigInteger(static_cast<__int128>(rng() >> 1)) << static_cast<size_t>(rng() % 400), BigInteger(static_cast<__int128>(rng() >> 1) + 1));
+            BigFraction rhs(BigInteger(static_cast<__int128>(rng() >> 1)) << static_cast<size_t>(rng() % 400), BigInteger(static_cast<__int128>(rng() >> 1) + 1));
+            if ((i & 1) != 0)
+            {
+                rhs = lhs + BigFraction(BigInteger(1), BigInteger(1) << 500);
+            }
+            CHECK(bigOrder(lhs, rhs) == expectedOrder(lhs, rhs));
+            CHECK(bigOrder(rhs, lhs) == expectedOrder(rhs, lhs));
+        }
+    }
+}
+
+TEST_SUITE("Parallel sort") {
+    template <typename Int>
+    void checkSorted(std::vector<BasicFraction<Int>> values)
+    {
+        std::vector<BasicFraction<Int>> expected = values;
+        std::sort(expected.begin(), expected.end());
+        for (unsigned threads : {0U, 1U, 3U, 8U})
+        {
+            std::vector<BasicFraction<Int>> sorted = values;
+            sortFractions<Int>(sorted, threads);
+            CHECK(sorted == expected);
+        }
+    }
+
+    TEST_CASE("Matches std::sort on every backend and size") {
+        std::mt19937 rng(23);
+        checkSorted(randomFractions(rng, 100000, std::numeric_limits<int>::max()));
+        // Mostly duplicates, so long runs of equal keys
+        checkSorted(randomFractions(rng, 50000, 20));
+        for (size_t size : {size_t(0), size_t(1), SORT_MIN_RADIX - 1, SORT_MIN_RADIX})
+        {
+            checkSorted(randomFractions(rng, size, 1000));
+        }
+
+        std::vector<Fraction64> values64;
+        std::vector<Fraction128> values128;
+        std::mt19937_64 rng64(23);
+        for (int i = 0; i < 20000; ++i)
+        {
+            auto num = static_cast<int64_t>(rng64() >> (1 + rng64() % 63));
+            values64.emplace_back((i & 1) != 0 ? -num : num, static_cast<int64_t>(rng64() >> 1) + 1);
+            __int128 wide = static_cast<__int128>((static_cast<unsigned __int128>(rng64()) << 64 | rng64()) >> (1 + rng64() % 100));
+            values128.emplace_back((i & 1) != 0 ? -wide : wide, static_cast<__int128>(rng64()) * 4093 + 1);
+        }
+        checkSorted(values64);
+        checkSorted(values128);
+    }
+
+    // Neighbours (b - 1) / b with large b differ by about 1 / b^2, far below what a double
+    // resolves, so their keys tie and only the exact pass orders them
+    TEST_CASE("Values closer than a double resolves") {
+        std::mt19937 rng(24);
+        std::vector<Fraction> values;
+        std::vector<Fraction64> values64;
+        std::vector<Fraction128> values128;
+        const __int128 base128 = static_cast<__int128>(1) << 120;
+        for (int step = 0; step < 6000; ++step)
+        {
+            int den = std::numeric_limits<int>::max() - step;
+            int64_t den64 = std::numeric_limits<int64_t>::max() - step;
+            __int128 den128 = base128 + step;
+            int sign = (step % 3) == 0 ? -1 : 1;
+            values.emplace_back(sign * (den - 1), den);
+            values64.emplace_back(sign * (den64 - 1), den64);
+            values128.emplace_back(sign * (den128 - 1), den128);
+        }
+        // Both terms of the first round in opposite directions, so its quotient drops
+        // below 1 while the second rounds to exactly 1: the keys land in neighbouring
+        // groups in the wrong order
+        const int64_t base64 = int64_t(1) << 62;
+        values64.emplace_back(base64 + 512, base64 + 513);
+        values64.emplace_back(base64 + 255, base64 + 256);
+        values64.emplace_back(1);
+        std::shuffle(values.begin(), values.end(), rng);
+        std::shuffle(values64.begin(), values64.end(), rng);
+        std::shuffle(values128.begin(), values128.end(), rng);
+        checkSorted(values);
+        checkSorted(values64);
+        checkSorted(values128);
+    }
+}
+
+TEST_SUITE("Fraction hashing") {
+    TEST_CASE("std::hash agrees with == and spreads the low bits") {
+        CHECK_EQ(std::hash<Fraction>{}(Fraction(2, 4)), std::hash<Fraction>{}(Fraction(-1, -2)));
+        CHECK_EQ(std::hash<Fraction128>{}(Fraction128(6, -9)), std::hash<Fraction128>{}(Fraction128(-2, 3)));
+        CHECK_NE(std::hash<Fraction>{}(Fraction(1, 2)), std::hash<Fraction>{}(Fraction(2, 1)));
+        CHECK_NE(std::hash<Fraction64>{}(Fraction64(1, 2)), std::hash<Fraction64>{}(Fraction64(2, 1)));
+        static_assert(hashValue(Fraction(3, 4)) == hashValue(Fraction(6, 8)));
+
+        std::unordered_set<Fraction> seen{Fraction(1, 2), Fraction(2, 4), Fraction(3, 6), Fraction(1, 3)};
+        CHECK_EQ(seen.size(), 2);
+
+        // Sequential keys, the worst case for a weak mix, must fill 1024 buckets evenly
+        std::unordered_set<size_t> hashes;
+        std::vector<int> buckets(1024, 0);
+        for (int num = -64; num < 64; ++num)
+        {
+            for (int den = 1; den <= 64; ++den)
+            {
+                Fraction frac(num, den);
+                if (frac.getDenominator() == den)
+                {
+                    hashes.insert(std::hash<Fraction>{}(frac));
+                    ++buckets[std::hash<Fraction>{}(frac) & 1023];
+                }
+            }
+        }
+        size_t reduced = hashes.size();
+        CHECK_GT(reduced, 4000);
+        CHECK_LT(*std::max_element(buckets.begin(), buckets.end()), 16);
+    }
+
+    template <typename Int>
+    void checkAgainstUnorderedMap(std::mt19937 &rng, int range)
+    {
+        BasicFractionHashMap<Int, int> map;
+        std::unordered_map<BasicFraction<Int>, int> expected;
+        for (int step = 0; step < 40000; ++step)
+        {
+            BasicFraction<Int> key(static_cast<Int>(static_cast<int>(rng() % static_cast<unsigned>(2 * range + 1)) - range),
+                                   static_cast<Int>(rng() % static_cast<unsigned>(range) + 1));
+            if (rng() % 3 == 0)
+            {
+                CHECK_EQ(map.erase(key), expected.erase(key) == 1);
+            }
+            else
+            {
+                ++map[key];
+                ++expected[key];
+            }
+        }
+        CHECK_EQ(map.size(), expected.size());
+        size_t visited = 0;
+        for (const auto &entry : map)
+        {
+            REQUIRE(expected.count(entry.key()) == 1);
+            CHECK_EQ(entry.value, expected[entry.key()]);
+            ++visited;
+        }
+        CHECK_EQ(visited, expected.size());
+        for (const auto &[key, value] : expected)
+        {
+            REQUIRE(map.find(key) != nullptr);
+            CHECK_EQ(*map.find(key), value);
+        }
+    }
+
+    TEST_CASE("FractionHashMap matches std::unordered_map") {
+        std::mt19937 rng(24);
+        // A small key range gives long probe runs and many erases from inside them
+        checkAgainstUnorderedMap<int>(rng, 40);
+        checkAgainstUnorderedMap<int>(rng, 100000);
+        checkAgainstUnorderedMap<int64_t>(rng, 300);
+        checkAgainstUnorderedMap<__int128>(rng, 300);
+    }
+
+    TEST_CASE("FractionHashMap basics") {
+        FractionHashMap<std::string> names;
+        CHECK(names.empty());
+        CHECK(names.find(Fraction(1, 2)) == nullptr);
+        CHECK_FALSE(names.erase(Fraction(1, 2)));
+        CHECK(names.insert(Fraction(1, 2), "half").second);
+        CHECK_FALSE(names.insert(Fraction(2, 4), "two quarters").second);
+        CHECK_EQ(names[Fraction(1, 2)], "half");
+        // Zero is a key like any other; only a zero denominator marks a free slot
+        names[Fraction(0)] = "zero";
+        CHECK(names.contains(Fraction(0, 5)));
+        CHECK_EQ(names.size(), 2);
+        CHECK(names.begin() != names.end());
+
+        names.reserve(1000);
+        CHECK_GE(names.capacity() * FractionHashMap<std::string>::MAX_LOAD_PERCENT / 100, 1000);
+        CHECK_EQ(*names.find(Fraction(1, 2)), "half");
+        names.clear();
+        CHECK(names.empty());
+        CHECK(names.begin() == names.end());
+        CHECK(names.find(Fraction(0)) == nullptr);
+    }
+}
+
+TEST_SUITE("Fraction pool") {
+    TEST_CASE("Interning gives one dense id per value") {
+        FractionPool pool;
+        FractionPool::Id half = pool.intern(Fraction(1, 2));
+        CHECK_EQ(half, 0);
+        CHECK_EQ(pool.intern(Fraction(2, 4)), half);
+        CHECK_EQ(pool.intern(Fraction(-3, 4)), 1);
+        CHECK_EQ(pool.size(), 2);
+        CHECK_EQ(pool.value(half), Fraction(1, 2));
+        CHECK_EQ(pool.value(1), Fraction(-3, 4));
+        CHECK_THROWS_AS(pool.value(2), std::out_of_range);
+
+        // Past the first few blocks of the id table
+        for (int den = 1; den <= 5000; ++den)
+        {
+            CHECK_EQ(pool.value(pool.intern(Fraction(1, den))), Fraction(1, den));
+        }
+        CHECK_EQ(pool.size(), 5001);
+    }
+
+    TEST_CASE("Memoized arithmetic matches the operators") {
+        Fraction128Pool pool;
+        std::vector<Fraction128Pool::Id> ids;
+        for (int num = -4; num <= 4; ++num)
+        {
+            ids.push_back(pool.intern(Fraction128(num, 3)));
+            ids.push_back(pool.intern(Fraction128(num * 7 + 1, 5)));
+        }
+        for (int round = 0; round < 2; ++round)
+        {
+            for (Fraction128Pool::Id lhs : ids)
+            {
+                for (Fraction128Pool::Id rhs : ids)
+                {
+                    const Fraction128 &a = pool.value(lhs);
+                    const Fraction128 &b = pool.value(rhs);
+                    CHECK_EQ(pool.value(pool.add(lhs, rhs)), a + b);
+                    CHECK_EQ(pool.value(pool.subtract(lhs, rhs)), a - b);
+                    CHECK_EQ(pool.value(pool.multiply(lhs, rhs)), a * b);
+                    if (b != Fraction128(0))
+                    {
+                        CHECK_EQ(pool.value(pool.divide(lhs, rhs)), a / b);
+                    }
+                }
+            }
+            // Same ids from the memo, and again after it is dropped
+            pool.clearResults();
+        }
+        Fraction128Pool::Id zero = pool.intern(Fraction128(0));
+        CHECK_THROWS_AS(pool.divide(ids[0], zero), std::runtime_error);
+        CHECK_EQ(pool.multiply(ids[3], ids[5]), pool.multiply(ids[3], ids[5]));
+
+        FractionPool small;
+        FractionPool::Id max = small.intern(Fraction(std::numeric_limits<int>::max()));
+        CHECK_THROWS_AS(small.add(max, max), std::overflow_error);
+    }
+
+    TEST_CASE("Threads agree on every id") {
+        FractionPool pool;
+        const unsigned threads = 4;
+        std::vector<std::vector<FractionPool::Id>> seen(threads);
+        std::vector<std::thread> workers;
+        for (unsigned thread = 0; thread < threads; ++thread)
+        {
+            workers.emplace_back([&pool, &seen, thread]()
+                                 {
+                std::mt19937 rng(thread);
+                for (int step = 0; step < 20000; ++step)
+                {
+                    int value = static_cast<int>(rng() % 3000);
+                    FractionPool::Id id = pool.intern(Fraction(value, 7));
+                    // Products of two interned values, memoized by whichever thread comes first
+                    seen[thread].push_back(pool.multiply(id, pool.intern(Fraction(value % 11, 3))));
+                } });
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        for (unsigned thread = 0; thread < threads; ++thread)
+        {
+            std::mt19937 rng(thread);
+            for (FractionPool::Id id : seen[thread])
+            {
+                int value = static_cast<int>(rng() % 3000);
+                CHECK_EQ(pool.value(id), Fraction(value, 7) * Fraction(value % 11, 3));
+                CHECK_EQ(pool.intern(pool.value(id)), id);
+            }
+        }
+        std::unordered_set<Fraction> distinct;
+        for (FractionPool::Id id = 0; id < pool.size(); ++id)
+        {
+            distinct.insert(pool.value(id));
+        }
+        CHECK_EQ(distinct.size(), pool.size());
+    }
+}
@@ -0,0 +1,296 @@
+#include "BigFraction.hpp"
+#include <cmath>
+#include <stdexcept>
+using namespace std;
+
+namespace ariel
+{
+
+    BigFraction::BigFraction(long long num, long long den) : BigFraction(BigInteger(num), BigInteger(den))
+    {
+    }
+
+    BigFraction::BigFraction(BigInteger num, BigInteger den) : numerator(std::move(num)), denominator(std::move(den))
+    {
+        if (denominator.isZero())
+        {
+            FRACTION_THROW(std::invalid_argument, "Denominator cannot be zero");
+        }
+
+        reduce();
+    }
+
+    // Same 3 decimal rounding as the Fraction double constructor
+    BigFraction BigFraction::fromDecimal(double flt)
+    {
+        double rounded_flt = round(flt * 1000) / 1000;
+        return BigFraction(static_cast<long long>(rounded_flt * FRACTION_SCALE), FRACTION_SCALE);
+    }
+
+    void BigFraction::reduce()
+    {
+        BigInteger gcd = BigInteger::gcd(numerator, denominator);
+        if (gcd != BigInteger(1))
+        {
+            numerator /= gcd;
+            denominator /= gcd;
+        }
+
+        // Make sure the denominator is always positive
+        if (denominator.isNegative())
+        {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+    }
+
+    const BigInteger &BigFraction::getNumerator() const
+    {
+        return numerator;
+    }
+
+    const BigInteger &BigFraction::getDenominator() const
+    {
+        return denominator;
+    }
+
+    double BigFraction::toDouble() const
+    {
+        if (numerator.isSmall() && denominator.isSmall())
+        {
+            return numerator.toDouble() / denominator.toDouble();
+        }
+        // Keep the top 64 bits of each side so huge values do not turn into inf/inf
+        size_t num_bits = numerator.bitLength();
+        size_t den_bits = denominator.bitLength();
+        size_t num_shift = num_bits > 64 ? num_bits - 64 : 0;
+        size_t den_shift = den_bits > 64 ? den_bits - 64 : 0;
+        double ratio = (numerator >> num_shift).toDouble() / (denominator >> den_shift).toDouble();
+        return std::ldexp(ratio, static_cast<int>(num_shift) - static_cast<int>(den_shift));
+    }
+
+    BigFraction operator+(const BigFraction &other, const BigFraction &frac)
+    {
+        return BigFraction(other.numerator * frac.denominator + frac.numerator * other.denominator,
+                           other.denominator * frac.denominator);
+    }
+
+    BigFraction operator-(const BigFraction &other, const BigFraction &frac)
+    {
+        return BigFraction(other.numerator * frac.denominator - frac.numerator * other.denominator,
+                           other.denominator * frac.denominator);
+    }
+
+    BigFraction operator*(const BigFraction &other, const BigFraction &frac)
+    {
+        return BigFraction(other.numerator * frac.numerator, other.denominator * frac.denominator);
+    }
+
+    BigFraction operator/(const BigFraction &other, const BigFraction &frac)
+    {
+        if (frac.numerator.isZero())
+        {
+            FRACTION_THROW(std::runtime_error, "Denominator cannot be zero");
+        }
+        return BigFraction(other.numerator * frac.denominator, other.denominator * frac.numerator);
+    }
+
+    // The float overloads round the float operand to 3 decimals, then stay exact
+    BigFraction operator+(const BigFraction &other, float frac)
+    {
+        return other + BigFraction(frac);
+    }
+
+    BigFraction operator-(const BigFraction &other, float frac)
+    {
+        return other - BigFraction(frac);
+    }
+
+    BigFraction operator*(const BigFraction &other, float frac)
+    {
+        return other * BigFraction(frac);
+    }
+
+    BigFraction operator/(const BigFraction &other, float frac)
+    {
+        if (frac == 0)
+        {
+            FRACTION_THROW(std::runtime_error, "Denominator cannot be zero");
+        }
+        return other / BigFraction(frac);
+    }
+
+    BigFraction operator+(float frac, const BigFraction &other)
+    {
+        return BigFraction(frac) + other;
+    }
+
+    BigFraction operator-(float frac, const BigFraction &other)
+    {
+        return BigFraction(frac) - other;
+    }
+
+    BigFraction operator*(float frac, const BigFraction &other)
+    {
+        return BigFraction(frac) * other;
+    }
+
+    BigFraction operator/(float frac, const BigFraction &other)
+    {
+        if (other.numerator.isZero())
+        {
+            FRACTION_THROW(std::invalid_argument, "Denominator cannot be zero");
+        }
+        return BigFraction(frac) / other;
+    }
+
+    BigFraction &BigFraction::operator+=(const BigFraction &frac)
+    {
+        return *this = *this + frac;
+    }
+
+    BigFraction &BigFraction::operator-=(const BigFraction &frac)
+    {
+        return *this = *this - frac;
+    }
+
+    BigFraction &BigFraction::operator*=(const BigFraction &frac)
+    {
+        return *this = *this * frac;
+    }
+
+    BigFraction &BigFraction::operator/=(const BigFraction &frac)
+    {
+        return *this = *this / frac;
+    }
+
+    bool operator==(const BigFraction &other, const BigFraction &frac)
+    {
+        return (other.numerator == frac.numerator) && (other.denominator == frac.denominator);
+    }
+
+    bool operator==(const BigFraction &other, float frac)
+    {
+        float epsilon = 0.000001; // Same tolerance as Fraction == float
+        return std::abs(other.toDouble() - frac) < epsilon;
+    }
+
+    bool operator==(float frac, const BigFraction &other)
+    {
+        return other == frac;
+    }
+
+    bool operator!=(const BigFraction &other, const BigFraction &frac)
+    {
+        return !(other == frac);
+    }
+
+    // The cross products are two BigInteger multiplications, so the order is first read off
+    // scaled doubles, which decide unless the two values agree to about 48 bits. Signs
+    // decide before either.
+    int BigFraction::compare(const BigFraction &other, const BigFraction &frac)
+    {
+        int lhs_sign = other.numerator.sign();
+        int rhs_sign = frac.numerator.sign();
+        if (lhs_sign != rhs_sign || lhs_sign == 0)
+        {
+            return (lhs_sign > rhs_sign) - (lhs_sign < rhs_sign);
+        }
+        long exponents[4] = {};
+        double lhs = std::abs(other.numerator.toScaledDouble(exponents[0])) * frac.denominator.toScaledDouble(exponents[1]);
+        double rhs = std::abs(frac.numerator.toScaledDouble(exponents[2])) * other.denominator.toScaledDouble(exponents[3]);
+        // Both products are in [0.25, 1) times 2^exponent, so exponents three apart decide
+        long shift = (exponents[0] + exponents[1]) - (exponents[2] + exponents[3]);
+        int order = 0;
+        if (shift >= 3 || shift <= -3)
+        {
+            order = shift > 0 ? 1 : -1;
+        }
+        else
+        {
+            lhs = std::ldexp(lhs, static_cast<int>(shift));
+            double bound = (lhs + rhs) * 0x1p-48;
+            order = lhs - rhs > bound ? 1 : (rhs - lhs > bound ? -1 : 0);
+        }
+        if (order != 0)
+        {
+            return lhs_sign > 0 ? order : -order;
+        }
+        BigInteger lhs_exact = other.numerator * frac.denominator;
+        BigInteger rhs_exact = frac.numerator * other.denominator;
+        return (rhs_exact < lhs_exact) - (lhs_exact < rhs_exact);
+    }
+
+    bool operator>(const BigFraction &other, const BigFraction &frac)
+    {
+        return BigFraction::compare(other, frac) > 0;
+    }
+
+    bool operator<(const BigFraction &other, const BigFraction &frac)
+    {
+        return BigFraction::compare(other, frac) < 0;
+    }
+
+    bool operator>=(const BigFraction &other, const BigFraction &frac)
+    {
+        return BigFraction::compare(other, frac) >= 0;
+    }
+
+    bool operator<=(const BigFraction &other, const BigFraction &frac)
+    {
+        return BigFraction::compare(other, frac) <= 0;
+    }
+
+    BigFraction &BigFraction::operator++()
+    {
+        numerator += denominator;
+        return *this;
+    }
+
+    BigFraction BigFraction::operator++(int)
+    {
+        BigFraction t(*this);
+        numerator += denominator;
+        return t;
+    }
+
+    BigFraction &BigFraction::operator--()
+    {
+        numerator -= denominator;
+        return *this;
+    }
+
+    BigFraction BigFraction::operator--(int)
+    {
+        BigFraction t(*this);
+        numerator -= denominator;
+        return t;
+    }
+
+    std::ostream &operator<<(std::ostream &ost, const BigFraction &frac)
+    {
+        ost << frac.numerator << '/' << frac.denominator;
+        return ost;
+    }
+
+    std::istream &operator>>(std::istream &ist, BigFraction &frac)
+    {
+        BigInteger numerator;
+        BigInteger denominator;
+        ist >> numerator >> denominator;
+
+        if (ist.fail())
+        {
+            FRACTION_THROW(std::runtime_error, "Invalid input format");
+        }
+
+        if (denominator.isZero())
+        {
+            FRACTION_THROW(std::runtime_error, "Invalid fraction format");
+        }
+
+        frac = BigFraction(numerator, denominator);
+        return ist;
+    }
+
+}
@@ -0,0 +1,71 @@
+#ifndef BIGFRACTION_HPP
+#define BIGFRACTION_HPP
+
+#include "Fraction.hpp"
+#include "BigInteger.hpp"
+
+namespace ariel
+{
+    // Exact rational over BigInteger numerator and denominator.
+    // Mirrors the operator surface of Fraction but grows instead of throwing
+    // std::overflow_error. Values that stay below 2^64 never leave the inline slots.
+    class BigFraction
+    {
+    private:
+        BigInteger numerator, denominator;
+
+        static BigFraction fromDecimal(double flt);
+        static int compare(const BigFraction &other, const BigFraction &frac);
+
+    public:
+        BigFraction(long long num = 0, long long den = 1);
+        BigFraction(BigInteger num, BigInteger den = BigInteger(1));
+        template <typename Int>
+        BigFraction(const BasicFraction<Int> &frac) : BigFraction(BigInteger(frac.getNumerator()), BigInteger(frac.getDenominator())) {}
+        template <std::floating_point Float>
+        BigFraction(Float flt) : BigFraction(fromDecimal(static_cast<double>(flt))) {}
+        void reduce();
+
+        const BigInteger &getNumerator() const;
+        const BigInteger &getDenominator() const;
+        double toDouble() const;
+
+        friend BigFraction operator+(const BigFraction &other, const BigFraction &frac);
+        friend BigFraction operator-(const BigFraction &other, const BigFraction &frac);
+        friend BigFraction operator*(const BigFraction &other, const BigFraction &frac);
+        friend BigFraction operator/(const BigFraction &other, const BigFraction &frac);
+
+        friend BigFraction operator+(const BigFraction &other, float frac);
+        friend BigFraction operator-(const BigFraction &other, float frac);
+        friend BigFraction operator*(const BigFraction &other, float frac);
+        friend BigFraction operator/(const BigFraction &other, float frac);
+
+        friend BigFraction operator+(float frac, const BigFraction &other);
+        friend BigFraction operator-(float frac, const BigFraction &other);
+        friend BigFraction operator*(float frac, const BigFraction &other);
+        friend BigFraction operator/(float frac, const BigFraction &other);
+
+        BigFraction &operator+=(const BigFraction &frac);
+        BigFraction &operator-=(const BigFraction &frac);
+        BigFraction &operator*=(const BigFraction &frac);
+        BigFraction &operator/=(const BigFraction &frac);
+
+        friend bool operator==(const BigFraction &other, const BigFraction &frac);
+        friend bool operator!=(const BigFraction &other, const BigFraction &frac);
+        friend bool operator>(const BigFraction &other, const BigFraction &frac);
+        friend bool operator<(const BigFraction &other, const BigFraction &frac);
+        friend bool operator>=(const BigFraction &other, const BigFraction &frac);
+        friend bool operator<=(const BigFraction &other, const BigFraction &frac);
+        friend bool operator==(const BigFraction &other, float frac);
+        friend bool operator==(float frac, const BigFraction &other);
+
+        BigFraction &operator++();
+        BigFraction operator++(int);
+        BigFraction &operator--();
+        BigFraction operator--(int);
+        friend std::ostream &operator<<(std::ostream &ost, const BigFraction &frac);
+        friend std::istream &operator>>(std::istream &ist, BigFraction &frac);
+    };
+}
+
+#endif // BIGFRACTION_HPP
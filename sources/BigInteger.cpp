@@ -0,0 +1,693 @@
+#include "BigInteger.hpp"
+#include "FractionError.hpp"
+#include "Gcd.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+using namespace std;
+
+namespace ariel
+{
+
+    namespace
+    {
+        using Limbs = std::vector<uint32_t>;
+
+        const uint64_t LIMB_BASE = uint64_t(1) << 32;
+        const uint32_t DECIMAL_CHUNK = 1000000000; // 10^9, the largest power of ten below 2^32
+        const int DECIMAL_CHUNK_DIGITS = 9;
+
+        // Drop the most significant zero limbs
+        void trim(Limbs &mag)
+        {
+            while (!mag.empty() && mag.back() == 0)
+            {
+                mag.pop_back();
+            }
+        }
+
+        int compareLimbs(const Limbs &lhs, const Limbs &rhs)
+        {
+            if (lhs.size() != rhs.size())
+            {
+                return lhs.size() < rhs.size() ? -1 : 1;
+            }
+            for (size_t i = lhs.size(); i-- > 0;)
+            {
+                if (lhs[i] != rhs[i])
+                {
+                    return lhs[i] < rhs[i] ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        Limbs addLimbs(const Limbs &lhs, const Limbs &rhs)
+        {
+            const Limbs &longer = lhs.size() >= rhs.size() ? lhs : rhs;
+            const Limbs &shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+            Limbs sum(longer.size() + 1, 0);
+            uint64_t carry = 0;
+            for (size_t i = 0; i < longer.size(); ++i)
+            {
+                uint64_t digit = uint64_t(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+                sum[i] = static_cast<uint32_t>(digit);
+                carry = digit >> 32;
+            }
+            sum[longer.size()] = static_cast<uint32_t>(carry);
+            trim(sum);
+            return sum;
+        }
+
+        // lhs - rhs, where lhs >= rhs
+        Limbs subLimbs(const Limbs &lhs, const Limbs &rhs)
+        {
+            Limbs diff(lhs.size(), 0);
+            int64_t borrow = 0;
+            for (size_t i = 0; i < lhs.size(); ++i)
+            {
+                int64_t digit = int64_t(lhs[i]) - (i < rhs.size() ? int64_t(rhs[i]) : 0) - borrow;
+                borrow = digit < 0 ? 1 : 0;
+                diff[i] = static_cast<uint32_t>(digit + (borrow != 0 ? int64_t(LIMB_BASE) : 0));
+            }
+            trim(diff);
+            return diff;
+        }
+
+        Limbs mulLimbs(const Limbs &lhs, const Limbs &rhs)
+        {
+            if (lhs.empty() || rhs.empty())
+            {
+                return {};
+            }
+            Limbs prod(lhs.size() + rhs.size(), 0);
+            for (size_t i = 0; i < lhs.size(); ++i)
+            {
+                uint64_t carry = 0;
+                for (size_t j = 0; j < rhs.size(); ++j)
+                {
+                    uint64_t digit = uint64_t(lhs[i]) * rhs[j] + prod[i + j] + carry;
+                    prod[i + j] = static_cast<uint32_t>(digit);
+                    carry = digit >> 32;
+                }
+                prod[i + rhs.size()] = static_cast<uint32_t>(carry);
+            }
+            trim(prod);
+            return prod;
+        }
+
+        // Multiply by a single limb and add a single limb, in place
+        void mulAddSmall(Limbs &mag, uint32_t factor, uint32_t addend)
+        {
+            uint64_t carry = addend;
+            for (uint32_t &limb : mag)
+            {
+                uint64_t digit = uint64_t(limb) * factor + carry;
+                limb = static_cast<uint32_t>(digit);
+                carry = digit >> 32;
+            }
+            if (carry != 0)
+            {
+                mag.push_back(static_cast<uint32_t>(carry));
+            }
+        }
+
+        // Divide by a single limb in place and return the remainder
+        uint32_t divSmall(Limbs &mag, uint32_t divisor)
+        {
+            uint64_t rem = 0;
+            for (size_t i = mag.size(); i-- > 0;)
+            {
+                uint64_t cur = (rem << 32) | mag[i];
+                mag[i] = static_cast<uint32_t>(cur / divisor);
+                rem = cur % divisor;
+            }
+            trim(mag);
+            return static_cast<uint32_t>(rem);
+        }
+
+        Limbs shiftLeftLimbs(const Limbs &mag, size_t bits)
+        {
+            if (mag.empty())
+            {
+                return {};
+            }
+            size_t limb_shift = bits / 32;
+            auto bit_shift = static_cast<unsigned>(bits % 32);
+            Limbs out(mag.size() + limb_shift + 1, 0);
+            for (size_t i = 0; i < mag.size(); ++i)
+            {
+                uint64_t cur = uint64_t(mag[i]) << bit_shift;
+                out[i + limb_shift] |= static_cast<uint32_t>(cur);
+                out[i + limb_shift + 1] |= static_cast<uint32_t>(cur >> 32);
+            }
+            trim(out);
+            return out;
+        }
+
+        Limbs shiftRightLimbs(const Limbs &mag, size_t bits)
+        {
+            size_t limb_shift = bits / 32;
+            if (limb_shift >= mag.size())
+            {
+                return {};
+            }
+            auto bit_shift = static_cast<unsigned>(bits % 32);
+            Limbs out(mag.size() - limb_shift, 0);
+            for (size_t i = 0; i < out.size(); ++i)
+            {
+                uint64_t cur = mag[i + limb_shift];
+                if (i + limb_shift + 1 < mag.size())
+                {
+                    cur |= uint64_t(mag[i + limb_shift + 1]) << 32;
+                }
+                out[i] = static_cast<uint32_t>(cur >> bit_shift);
+            }
+            trim(out);
+            return out;
+        }
+
+        // Knuth's algorithm D (TAOCP 4.3.1) on normalized 32-bit limbs.
+        // Requires divisor.size() >= 2 and dividend >= divisor.
+        void divmodLimbs(const Limbs &dividend, const Limbs &divisor, Limbs &quot, Limbs &rem)
+        {
+            size_t n = divisor.size();
+            size_t m = dividend.size() - n;
+            auto shift = static_cast<size_t>(std::countl_zero(divisor.back()));
+            Limbs vn = shiftLeftLimbs(divisor, shift);
+            Limbs un = shiftLeftLimbs(dividend, shift);
+            un.resize(dividend.size() + 1, 0);
+            quot.assign(m + 1, 0);
+
+            for (size_t j = m + 1; j-- > 0;)
+            {
+                uint64_t top = (uint64_t(un[j + n]) << 32) | un[j + n - 1];
+                uint64_t qhat = top / vn[n - 1];
+                uint64_t rhat = top % vn[n - 1];
+                while (qhat >= LIMB_BASE || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]))
+                {
+                    --qhat;
+                    rhat += vn[n - 1];
+                    if (rhat >= LIMB_BASE)
+                    {
+                        break;
+                    }
+                }
+
+                // Multiply and subtract qhat * divisor from the current window
+                int64_t borrow = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    uint64_t prod = qhat * vn[i];
+                    int64_t diff = int64_t(un[i + j]) - borrow - static_cast<int64_t>(prod & 0xFFFFFFFFU);
+                    un[i + j] = static_cast<uint32_t>(diff);
+                    borrow = static_cast<int64_t>(prod >> 32) - (diff >> 32);
+                }
+                int64_t diff = int64_t(un[j + n]) - borrow;
+                un[j + n] = static_cast<uint32_t>(diff);
+
+                quot[j] = static_cast<uint32_t>(qhat);
+                if (diff < 0)
+                {
+                    // qhat was one too large: add the divisor back
+                    --quot[j];
+                    uint64_t carry = 0;
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        uint64_t sum = uint64_t(un[i + j]) + vn[i] + carry;
+                        un[i + j] = static_cast<uint32_t>(sum);
+                        carry = sum >> 32;
+                    }
+                    un[j + n] += static_cast<uint32_t>(carry);
+                }
+            }
+            trim(quot);
+            un.resize(n);
+            trim(un);
+            rem = shiftRightLimbs(un, shift);
+        }
+    }
+
+    BigInteger::BigInteger(__int128 value) : negative(value < 0), small(0)
+    {
+        auto mag = static_cast<unsigned __int128>(value);
+        if (negative)
+        {
+            mag = 0 - mag;
+        }
+        assignMagnitude(mag, negative);
+    }
+
+    BigInteger::BigInteger(const std::string &digits) : BigInteger()
+    {
+        size_t pos = 0;
+        bool neg = false;
+        if (pos < digits.size() && (digits[pos] == '-' || digits[pos] == '+'))
+        {
+            neg = digits[pos] == '-';
+            ++pos;
+        }
+        if (pos == digits.size())
+        {
+            FRACTION_THROW(std::invalid_argument, "BigInteger needs at least one digit");
+        }
+        Limbs mag;
+        while (pos < digits.size())
+        {
+            // Consume up to nine digits at a time so most of the work is a single mulAddSmall
+            uint32_t chunk = 0;
+            uint32_t scale = 1;
+            for (int i = 0; i < DECIMAL_CHUNK_DIGITS && pos < digits.size(); ++i, ++pos)
+            {
+                if (std::isdigit(static_cast<unsigned char>(digits[pos])) == 0)
+                {
+                    FRACTION_THROW(std::invalid_argument, "BigInteger expects decimal digits");
+                }
+                chunk = chunk * 10 + static_cast<uint32_t>(digits[pos] - '0');
+                scale *= 10;
+            }
+            mulAddSmall(mag, scale, chunk);
+        }
+        trim(mag);
+        assignMagnitude(std::move(mag), neg);
+    }
+
+    BigInteger::Limbs BigInteger::magnitudeLimbs() const
+    {
+        if (!isInline())
+        {
+            return limbs;
+        }
+        Limbs mag{static_cast<uint32_t>(small), static_cast<uint32_t>(small >> 32)};
+        trim(mag);
+        return mag;
+    }
+
+    // Store a magnitude, moving it back inline whenever it fits in 64 bits
+    void BigInteger::assignMagnitude(Limbs mag, bool neg)
+    {
+        trim(mag);
+        if (mag.size() <= 2)
+        {
+            small = mag.empty() ? 0 : mag[0];
+            if (mag.size() == 2)
+            {
+                small |= uint64_t(mag[1]) << 32;
+            }
+            limbs.clear();
+            limbs.shrink_to_fit();
+        }
+        else
+        {
+            small = 0;
+            limbs = std::move(mag);
+        }
+        negative = neg && !isZero();
+    }
+
+    void BigInteger::assignMagnitude(unsigned __int128 mag, bool neg)
+    {
+        if ((mag >> 64) == 0)
+        {
+            small = static_cast<uint64_t>(mag);
+            limbs.clear();
+        }
+        else
+        {
+            limbs = {static_cast<uint32_t>(mag), static_cast<uint32_t>(mag >> 32),
+                     static_cast<uint32_t>(mag >> 64), static_cast<uint32_t>(mag >> 96)};
+            trim(limbs);
+            small = 0;
+        }
+        negative = neg && !isZero();
+    }
+
+    int BigInteger::compareMagnitude(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        if (lhs.isInline() && rhs.isInline())
+        {
+            return lhs.small == rhs.small ? 0 : (lhs.small < rhs.small ? -1 : 1);
+        }
+        return compareLimbs(lhs.magnitudeLimbs(), rhs.magnitudeLimbs());
+    }
+
+    size_t BigInteger::bitLength() const
+    {
+        if (isInline())
+        {
+            return static_cast<size_t>(64 - std::countl_zero(small));
+        }
+        return limbs.size() * 32 - static_cast<size_t>(std::countl_zero(limbs.back()));
+    }
+
+    bool BigInteger::isEven() const
+    {
+        return isInline() ? (small & 1U) == 0 : (limbs[0] & 1U) == 0;
+    }
+
+    bool BigInteger::fitsInt64() const
+    {
+        if (!isInline())
+        {
+            return false;
+        }
+        return negative ? small <= (uint64_t(1) << 63) : small < (uint64_t(1) << 63);
+    }
+
+    int64_t BigInteger::toInt64() const
+    {
+        if (!fitsInt64())
+        {
+            FRACTION_THROW(std::range_error, "BigInteger does not fit in int64_t");
+        }
+        return negative ? static_cast<int64_t>(0 - small) : static_cast<int64_t>(small);
+    }
+
+    bool BigInteger::fitsInt128() const
+    {
+        // Magnitudes below 2^127 fit either way; 2^127 itself only as the most negative value
+        size_t bits = bitLength();
+        return bits < 128 || (negative && abs() == (BigInteger(1) << 127));
+    }
+
+    __int128 BigInteger::toInt128() const
+    {
+        if (!fitsInt128())
+        {
+            FRACTION_THROW(std::range_error, "BigInteger does not fit in __int128");
+        }
+        unsigned __int128 mag = 0;
+        Limbs digits = magnitudeLimbs();
+        for (size_t i = digits.size(); i-- > 0;)
+        {
+            mag = (mag << 32) | digits[i];
+        }
+        return negative ? static_cast<__int128>(0 - mag) : static_cast<__int128>(mag);
+    }
+
+    double BigInteger::toDouble() const
+    {
+        double mag = 0;
+        if (isInline())
+        {
+            mag = static_cast<double>(small);
+        }
+        else
+        {
+            // The top 64 bits carry more precision than a double can hold
+            size_t drop = bitLength() - 64;
+            Limbs top = shiftRightLimbs(limbs, drop);
+            uint64_t head = uint64_t(top[0]) | (uint64_t(top[1]) << 32);
+            mag = std::ldexp(static_cast<double>(head), static_cast<int>(drop));
+        }
+        return negative ? -mag : mag;
+    }
+
+    double BigInteger::toScaledDouble(long &exponent) const
+    {
+        int binary_exponent = 0;
+        if (isInline())
+        {
+            double mantissa = std::frexp(static_cast<double>(small), &binary_exponent);
+            exponent = binary_exponent;
+            return negative ? -mantissa : mantissa;
+        }
+        // Out-of-line values have at least three limbs; the top three hold 65 or more
+        // significant bits, more than the double keeps
+        size_t count = limbs.size();
+        unsigned __int128 head = (static_cast<unsigned __int128>(limbs[count - 1]) << 64) |
+                                 (static_cast<unsigned __int128>(limbs[count - 2]) << 32) | limbs[count - 3];
+        double mantissa = std::frexp(static_cast<double>(head), &binary_exponent);
+        exponent = binary_exponent + static_cast<long>(32 * (count - 3));
+        return negative ? -mantissa : mantissa;
+    }
+
+    std::string BigInteger::toString() const
+    {
+        if (isInline())
+        {
+            return (negative ? "-" : "") + std::to_string(small);
+        }
+        Limbs mag = limbs;
+        std::string digits;
+        while (!mag.empty())
+        {
+            uint32_t chunk = divSmall(mag, DECIMAL_CHUNK);
+            for (int i = 0; i < DECIMAL_CHUNK_DIGITS && (!mag.empty() || chunk != 0); ++i)
+            {
+                digits.push_back(static_cast<char>('0' + chunk % 10));
+                chunk /= 10;
+            }
+        }
+        if (negative)
+        {
+            digits.push_back('-');
+        }
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+    BigInteger BigInteger::abs() const
+    {
+        BigInteger result(*this);
+        result.negative = false;
+        return result;
+    }
+
+    BigInteger BigInteger::operator-() const
+    {
+        BigInteger result(*this);
+        result.negative = !negative && !isZero();
+        return result;
+    }
+
+    BigInteger BigInteger::addSigned(const BigInteger &lhs, const BigInteger &rhs, bool negate_rhs)
+    {
+        bool rhs_negative = rhs.negative != negate_rhs;
+        BigInteger result;
+        if (lhs.negative == rhs_negative)
+        {
+            if (lhs.isInline() && rhs.isInline())
+            {
+                result.assignMagnitude(static_cast<unsigned __int128>(lhs.small) + rhs.small, lhs.negative);
+            }
+            else
+            {
+                result.assignMagnitude(addLimbs(lhs.magnitudeLimbs(), rhs.magnitudeLimbs()), lhs.negative);
+            }
+            return result;
+        }
+
+        // Opposite signs: subtract the smaller magnitude from the larger one
+        int cmp = compareMagnitude(lhs, rhs);
+        if (cmp == 0)
+        {
+            return result;
+        }
+        const BigInteger &larger = cmp > 0 ? lhs : rhs;
+        const BigInteger &smaller = cmp > 0 ? rhs : lhs;
+        bool neg = cmp > 0 ? lhs.negative : rhs_negative;
+        if (larger.isInline())
+        {
+            result.assignMagnitude(static_cast<unsigned __int128>(larger.small - smaller.small), neg);
+        }
+        else
+        {
+            result.assignMagnitude(subLimbs(larger.magnitudeLimbs(), smaller.magnitudeLimbs()), neg);
+        }
+        return result;
+    }
+
+    BigInteger operator+(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        return BigInteger::addSigned(lhs, rhs, false);
+    }
+
+    BigInteger operator-(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        return BigInteger::addSigned(lhs, rhs, true);
+    }
+
+    BigInteger operator*(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        BigInteger result;
+        bool neg = lhs.negative != rhs.negative;
+        if (lhs.isInline() && rhs.isInline())
+        {
+            result.assignMagnitude(static_cast<unsigned __int128>(lhs.small) * rhs.small, neg);
+        }
+        else
+        {
+            result.assignMagnitude(mulLimbs(lhs.magnitudeLimbs(), rhs.magnitudeLimbs()), neg);
+        }
+        return result;
+    }
+
+    void BigInteger::divmod(const BigInteger &lhs, const BigInteger &rhs, BigInteger &quot, BigInteger &rem)
+    {
+        if (rhs.isZero())
+        {
+            FRACTION_THROW(std::invalid_argument, "BigInteger division by zero");
+        }
+        bool quot_negative = lhs.negative != rhs.negative;
+        bool rem_negative = lhs.negative;
+        if (lhs.isInline() && rhs.isInline())
+        {
+            uint64_t q = lhs.small / rhs.small;
+            uint64_t r = lhs.small % rhs.small;
+            quot.assignMagnitude(q, quot_negative);
+            rem.assignMagnitude(r, rem_negative);
+            return;
+        }
+        if (compareMagnitude(lhs, rhs) < 0)
+        {
+            rem = lhs;
+            quot = BigInteger();
+            return;
+        }
+        Limbs dividend = lhs.magnitudeLimbs();
+        Limbs divisor = rhs.magnitudeLimbs();
+        Limbs q;
+        Limbs r;
+        if (divisor.size() == 1)
+        {
+            q = dividend;
+            r = {divSmall(q, divisor[0])};
+        }
+        else
+        {
+            divmodLimbs(dividend, divisor, q, r);
+        }
+        quot.assignMagnitude(std::move(q), quot_negative);
+        rem.assignMagnitude(std::move(r), rem_negative);
+    }
+
+    BigInteger operator/(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        BigInteger quot;
+        BigInteger rem;
+        BigInteger::divmod(lhs, rhs, quot, rem);
+        return quot;
+    }
+
+    BigInteger operator%(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        BigInteger quot;
+        BigInteger rem;
+        BigInteger::divmod(lhs, rhs, quot, rem);
+        return rem;
+    }
+
+    BigInteger operator<<(const BigInteger &lhs, size_t bits)
+    {
+        BigInteger result;
+        result.assignMagnitude(shiftLeftLimbs(lhs.magnitudeLimbs(), bits), lhs.negative);
+        return result;
+    }
+
+    BigInteger operator>>(const BigInteger &lhs, size_t bits)
+    {
+        // Shifts the magnitude, so negative values round toward zero
+        BigInteger result;
+        if (lhs.isInline())
+        {
+            result.assignMagnitude(bits >= 64 ? 0 : lhs.small >> bits, lhs.negative);
+        }
+        else
+        {
+            result.assignMagnitude(shiftRightLimbs(lhs.limbs, bits), lhs.negative);
+        }
+        return result;
+    }
+
+    BigInteger BigInteger::gcd(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        BigInteger a = lhs.abs();
+        BigInteger b = rhs.abs();
+        // Euclid on the limbs until both sides fit inline, then finish in machine words
+        while (!(a.isInline() && b.isInline()))
+        {
+            if (b.isZero())
+            {
+                return a;
+            }
+            BigInteger quot;
+            BigInteger rem;
+            divmod(a, b, quot, rem);
+            a = std::move(b);
+            b = std::move(rem);
+        }
+        BigInteger result;
+        result.assignMagnitude(kernelGcd(a.small, b.small), false);
+        return result;
+    }
+
+    bool operator==(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        return lhs.negative == rhs.negative && BigInteger::compareMagnitude(lhs, rhs) == 0;
+    }
+
+    bool operator!=(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    bool operator<(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        if (lhs.negative != rhs.negative)
+        {
+            return lhs.negative;
+        }
+        int cmp = BigInteger::compareMagnitude(lhs, rhs);
+        return lhs.negative ? cmp > 0 : cmp < 0;
+    }
+
+    bool operator>(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        return rhs < lhs;
+    }
+
+    bool operator<=(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    bool operator>=(const BigInteger &lhs, const BigInteger &rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    std::ostream &operator<<(std::ostream &ost, const BigInteger &value)
+    {
+        ost << value.toString();
+        return ost;
+    }
+
+    std::istream &operator>>(std::istream &ist, BigInteger &value)
+    {
+        std::istream::sentry sentry(ist);
+        if (!sentry)
+        {
+            return ist;
+        }
+        std::string digits;
+        if (ist.peek() == '-' || ist.peek() == '+')
+        {
+            digits.push_back(static_cast<char>(ist.get()));
+        }
+        while (std::isdigit(ist.peek()) != 0)
+        {
+            digits.push_back(static_cast<char>(ist.get()));
+        }
+        if (digits.empty() || std::isdigit(static_cast<unsigned char>(digits.back())) == 0)
+        {
+            ist.setstate(std::ios::failbit);
+            return ist;
+        }
+        value = BigInteger(digits);
+        return ist;
+    }
+
+}
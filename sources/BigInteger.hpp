@@ -0,0 +1,86 @@
+#ifndef BIGINTEGER_HPP
+#define BIGINTEGER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace ariel
+{
+    // Signed arbitrary-precision integer.
+    // Magnitudes below 2^64 are kept inline in `small`; larger ones spill to a vector of
+    // 32-bit limbs (least significant first), so values that stay small never allocate.
+    class BigInteger
+    {
+    private:
+        using Limbs = std::vector<uint32_t>;
+
+        bool negative;
+        uint64_t small;
+        Limbs limbs;
+
+        bool isInline() const { return limbs.empty(); }
+        Limbs magnitudeLimbs() const;
+        void assignMagnitude(Limbs mag, bool neg);
+        void assignMagnitude(unsigned __int128 mag, bool neg);
+
+        static int compareMagnitude(const BigInteger &lhs, const BigInteger &rhs);
+        static BigInteger addSigned(const BigInteger &lhs, const BigInteger &rhs, bool negate_rhs);
+
+    public:
+        BigInteger(__int128 value = 0);
+        explicit BigInteger(const std::string &digits);
+
+        bool isZero() const { return isInline() && small == 0; }
+        bool isNegative() const { return negative; }
+        // True while the magnitude still lives in the inline 64-bit slot
+        bool isSmall() const { return isInline(); }
+        int sign() const { return isZero() ? 0 : (negative ? -1 : 1); }
+        size_t bitLength() const;
+        bool isEven() const;
+
+        bool fitsInt64() const;
+        int64_t toInt64() const;
+        bool fitsInt128() const;
+        __int128 toInt128() const;
+        double toDouble() const;
+        // Value as mantissa * 2^exponent, |mantissa| in [0.5, 1) (0 for zero), with a
+        // relative error below 2^-52 and no allocation, so values past the double range
+        // still compare
+        double toScaledDouble(long &exponent) const;
+        std::string toString() const;
+
+        BigInteger abs() const;
+        BigInteger operator-() const;
+
+        // Truncating division, like the built-in integer types
+        static void divmod(const BigInteger &lhs, const BigInteger &rhs, BigInteger &quot, BigInteger &rem);
+        static BigInteger gcd(const BigInteger &lhs, const BigInteger &rhs);
+
+        friend BigInteger operator+(const BigInteger &lhs, const BigInteger &rhs);
+        friend BigInteger operator-(const BigInteger &lhs, const BigInteger &rhs);
+        friend BigInteger operator*(const BigInteger &lhs, const BigInteger &rhs);
+        friend BigInteger operator/(const BigInteger &lhs, const BigInteger &rhs);
+        friend BigInteger operator%(const BigInteger &lhs, const BigInteger &rhs);
+        friend BigInteger operator<<(const BigInteger &lhs, size_t bits);
+        friend BigInteger operator>>(const BigInteger &lhs, size_t bits);
+
+        BigInteger &operator+=(const BigInteger &rhs) { return *this = *this + rhs; }
+        BigInteger &operator-=(const BigInteger &rhs) { return *this = *this - rhs; }
+        BigInteger &operator*=(const BigInteger &rhs) { return *this = *this * rhs; }
+        BigInteger &operator/=(const BigInteger &rhs) { return *this = *this / rhs; }
+
+        friend bool operator==(const BigInteger &lhs, const BigInteger &rhs);
+        friend bool operator!=(const BigInteger &lhs, const BigInteger &rhs);
+        friend bool operator<(const BigInteger &lhs, const BigInteger &rhs);
+        friend bool operator>(const BigInteger &lhs, const BigInteger &rhs);
+        friend bool operator<=(const BigInteger &lhs, const BigInteger &rhs);
+        friend bool operator>=(const BigInteger &lhs, const BigInteger &rhs);
+
+        friend std::ostream &operator<<(std::ostream &ost, const BigInteger &value);
+        friend std::istream &operator>>(std::istream &ist, BigInteger &value);
+    };
+}
+
+#endif // BIGINTEGER_HPP
@@ -5,6 +5,13 @@
 #include <numeric>
 #include <limits>
 #include <cmath>
+#include <cstdint>
+#include <concepts>
+#include <bit>
+#include <compare>
+#include <functional>
+#include "FractionError.hpp"
+#include "Gcd.hpp"
 
 using namespace std;
 
@@ -12,55 +19,806 @@ namespace ariel
 {
     const int FRACTION_SCALE = 10000;
 
-    class Fraction
+    // Per-backend integer properties.
+    // wide_type holds the exact product of two Int values, so the arithmetic only has to
+    // check once whether the result narrows back into Int. __int128 has no wider type, so
+    // its products are checked with the compiler overflow builtins instead.
+    template <typename Int>
+    struct FractionTraits;
+
+    template <>
+    struct FractionTraits<int>
+    {
+        using wide_type = int64_t;
+        using unsigned_type = unsigned int;
+        static constexpr int max() { return std::numeric_limits<int>::max(); }
+        static constexpr int min() { return std::numeric_limits<int>::min(); }
+    };
+
+    template <>
+    struct FractionTraits<int64_t>
+    {
+        using wide_type = __int128;
+        using unsigned_type = uint64_t;
+        static constexpr int64_t max() { return std::numeric_limits<int64_t>::max(); }
+        static constexpr int64_t min() { return std::numeric_limits<int64_t>::min(); }
+    };
+
+    template <>
+    struct FractionTraits<__int128>
+    {
+        using wide_type = __int128;
+        using unsigned_type = unsigned __int128;
+        static constexpr __int128 max() { return static_cast<__int128>(~static_cast<unsigned __int128>(0) >> 1); }
+        static constexpr __int128 min() { return -max() - 1; }
+    };
+
+    // value as a double from the two 64-bit halves of its magnitude, within 2^-52 relative
+    // error, without the library call behind the direct __int128 conversion. Halves of a
+    // signed value would cancel for small negative numbers.
+    constexpr double approximateDouble(__int128 value)
+    {
+        auto mag = value < 0 ? -static_cast<unsigned __int128>(value) : static_cast<unsigned __int128>(value);
+        double result = static_cast<double>(static_cast<uint64_t>(mag >> 64)) * 0x1p64 + static_cast<double>(static_cast<uint64_t>(mag));
+        return value < 0 ? -result : result;
+    }
+
+    // Magnitude as the unsigned type. Negating in the unsigned domain gives the most
+    // negative value a magnitude too.
+    template <typename Int>
+    constexpr typename FractionTraits<Int>::unsigned_type magnitude(Int value)
+    {
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+        return value < 0 ? Unsigned(0) - static_cast<Unsigned>(value) : static_cast<Unsigned>(value);
+    }
+
+    template <intmax_t N, intmax_t D>
+    struct StaticFraction;
+
+    template <typename Int, typename Value>
+    class BasicFractionHashMap;
+
+    template <typename Int>
+    class BasicLazyFraction;
+
+    class FractionArray;
+
+    // Passkey for the BasicFraction entry points that trust their caller to pass an already
+    // reduced pair. Only the library types that hold one can make a key, and it opens
+    // nothing else of BasicFraction.
+    class ReducedKey
+    {
+    private:
+        // StaticFraction reduces its constants at compile time
+        template <intmax_t N, intmax_t D>
+        friend struct StaticFraction;
+        // The hash map marks empty slots with a zero denominator, which no value has
+        template <typename Int, typename Value>
+        friend class BasicFractionHashMap;
+        // LazyFraction hands out its fields once normalize() has reduced them
+        template <typename Int>
+        friend class BasicLazyFraction;
+        // FractionArray keeps its columns reduced
+        friend class FractionArray;
+
+        constexpr ReducedKey() {}
+    };
+
+    // The integer path (construction, reduce, + - * / between fractions, comparisons) is
+    // constexpr and defined below the class, so constant tables fold at compile time. The
+    // float overloads and the stream operators live in FractionImpl.hpp, which Fraction.cpp
+    // instantiates for the three backends, or which this header includes directly under
+    // FRACTION_HEADER_ONLY.
+    template <typename Int>
+    class BasicFraction
     {
     private:
-        int numerator, denominator;
+        using Wide = typename FractionTraits<Int>::wide_type;
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+
+        Int numerator, denominator;
+
+        static BasicFraction fromDecimal(double flt);
+        constexpr FractionError normalize();
+
+        // Exception-free core shared by the checked API and the throwing operators
+        static constexpr Checked<BasicFraction> sum(const BasicFraction &other, const BasicFraction &frac, bool subtract);
+        static constexpr Checked<BasicFraction> reducedProduct(Unsigned num_lhs, Unsigned num_rhs, Unsigned den_lhs, Unsigned den_rhs, bool negative);
+        static constexpr Checked<BasicFraction> product(const BasicFraction &other, const BasicFraction &frac);
+        static constexpr Checked<BasicFraction> quotient(const BasicFraction &other, const BasicFraction &frac);
+
+        static constexpr BasicFraction add(const BasicFraction &other, const BasicFraction &frac);
+        static constexpr BasicFraction subtract(const BasicFraction &other, const BasicFraction &frac);
+        static constexpr BasicFraction multiply(const BasicFraction &other, const BasicFraction &frac);
+        static constexpr BasicFraction divide(const BasicFraction &other, const BasicFraction &frac);
+
+        static BasicFraction add(const BasicFraction &other, float frac);
+        static BasicFraction subtract(const BasicFraction &other, float frac);
+        static BasicFraction multiply(const BasicFraction &other, float frac);
+        static BasicFraction divide(const BasicFraction &other, float frac);
+
+        static BasicFraction add(float frac, const BasicFraction &other);
+        static BasicFraction subtract(float frac, const BasicFraction &other);
+        static BasicFraction multiply(float frac, const BasicFraction &other);
+        static BasicFraction divide(float frac, const BasicFraction &other);
+
+        static bool equals(const BasicFraction &other, float frac);
+        static constexpr std::strong_ordering compare(const BasicFraction &other, const BasicFraction &frac);
+        static constexpr std::strong_ordering compareMagnitudes(Unsigned lhs_num, Unsigned lhs_den, Unsigned rhs_num, Unsigned rhs_den);
 
     public:
-        Fraction(int num = 0, int den = 1);
-        // Fraction(double flt) : numerator(static_cast<int>(flt * FRACTION_SCALE)), denominator(FRACTION_SCALE) {} // casting to a fraction
-        Fraction(double flt);
-        float roundFloat(float num);
-        // : numerator(static_cast<int>(std::round(flt * FRACTION_SCALE))), denominator(FRACTION_SCALE) {}
-       // float roundFloat(float num);
-        void reduce();
-
-        int getNumerator() const;
-        int getDenominator() const;
-
-        friend Fraction operator+(const Fraction &other, const Fraction &frac);
-        friend Fraction operator-(const Fraction &other, const Fraction &frac);
-        friend Fraction operator*(const Fraction &other, const Fraction &frac);
-        friend Fraction operator/(const Fraction &other, const Fraction &frac);
-
-        friend Fraction operator+(const Fraction &other, float frac);
-        friend Fraction operator-(const Fraction &other, float frac);
-        friend Fraction operator*(const Fraction &other, float frac);
-        friend Fraction operator/(const Fraction &other, float frac);
-
-        friend Fraction operator+(float frac, const Fraction &other);
-        friend Fraction operator-(float frac, const Fraction &other);
-        friend Fraction operator*(float frac, const Fraction &other);
-        friend Fraction operator/(float frac, const Fraction &other);
-
-        friend bool operator==(const Fraction &other, const Fraction &frac);
-        friend bool operator!=(const Fraction &other, const Fraction &frac);
-        friend bool operator>(const Fraction &other, const Fraction &frac);
-        friend bool operator<(const Fraction &other, const Fraction &frac);
-        friend bool operator>=(const Fraction &other, const Fraction &frac);
-        friend bool operator<=(const Fraction &other, const Fraction &frac);
-        friend bool operator==(const Fraction &other, float frac);
-        friend bool operator==(float frac, const Fraction &other);
-
-        Fraction &operator++();
-        Fraction operator++(int);
-        Fraction &operator--();
-        Fraction operator--(int);
-        friend std::ostream &operator<<(std::ostream &ost, const Fraction &frac);
-        friend std::istream &operator>>(std::istream &ist, Fraction &frac);
-        // friend std::istream& operator>>(std::istream& ist, std::pair<Fraction&, Fraction&> frac_pair);
+        constexpr BasicFraction(Int num = 0, Int den = 1);
+        // Only floating point arguments take the rounding path, so integers never become
+        // ambiguous between the (Int, Int) and the double constructor on the wider backends.
+        template <std::floating_point Float>
+        BasicFraction(Float flt) : BasicFraction(fromDecimal(static_cast<double>(flt))) {}
+        // Widening conversion. The source is already reduced, so no gcd is needed.
+        template <typename Narrow>
+            requires(sizeof(Narrow) < sizeof(Int))
+        constexpr explicit BasicFraction(const BasicFraction<Narrow> &frac) : numerator(frac.getNumerator()), denominator(frac.getDenominator()) {}
+        constexpr void reduce();
+
+        // num/den exactly as given: no gcd, no sign fix-up and no zero check
+        static constexpr BasicFraction fromReduced(ReducedKey /*key*/, Int num, Int den)
+        {
+            BasicFraction result;
+            result.numerator = num;
+            result.denominator = den;
+            return result;
+        }
+        // Product of two magnitudes the caller has already cancelled across the fraction bar
+        static constexpr Checked<BasicFraction> reducedProduct(ReducedKey /*key*/, Unsigned num_lhs, Unsigned num_rhs, Unsigned den_lhs, Unsigned den_rhs, bool negative)
+        {
+            return reducedProduct(num_lhs, num_rhs, den_lhs, den_rhs, negative);
+        }
+
+        // Non-throwing constructor: ZeroDenominator or Overflow instead of an exception
+        static constexpr Checked<BasicFraction> make(Int num, Int den = 1);
+
+        // Exact value of a double, read from its IEEE-754 bits: no rounding to 3 decimals
+        // and no gcd, since the denominator is a power of two. Overflow when the value
+        // needs more bits than Int has (most fractional doubles need Fraction64 or
+        // Fraction128), NotFinite for NaN and infinities.
+        static constexpr Checked<BasicFraction> checkedFromDouble(double value);
+        static constexpr BasicFraction fromDouble(double value);
+
+        // Closest fraction to value with a denominator of at most max_den (the smaller
+        // denominator on ties), e.g. approximate(0.333, 100) is 1/3. Runs continued
+        // fractions on the exact binary value of the double; values below 2^-74 are first
+        // truncated to 127 fractional bits.
+        static constexpr BasicFraction approximate(double value, Int max_den);
+
+        constexpr Int getNumerator() const;
+        constexpr Int getDenominator() const;
+
+        friend constexpr BasicFraction operator+(const BasicFraction &other, const BasicFraction &frac) { return add(other, frac); }
+        friend constexpr BasicFraction operator-(const BasicFraction &other, const BasicFraction &frac) { return subtract(other, frac); }
+        friend constexpr BasicFraction operator*(const BasicFraction &other, const BasicFraction &frac) { return multiply(other, frac); }
+        friend constexpr BasicFraction operator/(const BasicFraction &other, const BasicFraction &frac) { return divide(other, frac); }
+
+        friend BasicFraction operator+(const BasicFraction &other, float frac) { return add(other, frac); }
+        friend BasicFraction operator-(const BasicFraction &other, float frac) { return subtract(other, frac); }
+        friend BasicFraction operator*(const BasicFraction &other, float frac) { return multiply(other, frac); }
+        friend BasicFraction operator/(const BasicFraction &other, float frac) { return divide(other, frac); }
+
+        friend BasicFraction operator+(float frac, const BasicFraction &other) { return add(frac, other); }
+        friend BasicFraction operator-(float frac, const BasicFraction &other) { return subtract(frac, other); }
+        friend BasicFraction operator*(float frac, const BasicFraction &other) { return multiply(frac, other); }
+        friend BasicFraction operator/(float frac, const BasicFraction &other) { return divide(frac, other); }
+
+        // Same results as the operators above, with the error returned instead of thrown
+        friend constexpr Checked<BasicFraction> checkedAdd(const BasicFraction &other, const BasicFraction &frac) { return sum(other, frac, false); }
+        friend constexpr Checked<BasicFraction> checkedSubtract(const BasicFraction &other, const BasicFraction &frac) { return sum(other, frac, true); }
+        friend constexpr Checked<BasicFraction> checkedMultiply(const BasicFraction &other, const BasicFraction &frac) { return product(other, frac); }
+        friend constexpr Checked<BasicFraction> checkedDivide(const BasicFraction &other, const BasicFraction &frac) { return quotient(other, frac); }
+
+        friend constexpr bool operator==(const BasicFraction &other, const BasicFraction &frac)
+        {
+            return (other.numerator == frac.numerator) && (other.denominator == frac.denominator);
+        }
+        friend constexpr bool operator!=(const BasicFraction &other, const BasicFraction &frac) { return !(other == frac); }
+        // <, <=, > and >= are rewritten to this by the compiler, one comparison each
+        friend constexpr std::strong_ordering operator<=>(const BasicFraction &other, const BasicFraction &frac) { return compare(other, frac); }
+        friend bool operator==(const BasicFraction &other, float frac) { return equals(other, frac); }
+        friend bool operator==(float frac, const BasicFraction &other) { return equals(other, frac); }
+
+        constexpr BasicFraction &operator++();
+        constexpr BasicFraction operator++(int);
+        constexpr BasicFraction &operator--();
+        constexpr BasicFraction operator--(int);
+
+        template <typename T>
+        friend std::ostream &operator<<(std::ostream &ost, const BasicFraction<T> &frac);
+        template <typename T>
+        friend std::istream &operator>>(std::istream &ist, BasicFraction<T> &frac);
     };
+
+    template <typename Int>
+    constexpr BasicFraction<Int>::BasicFraction(Int numerator, Int denominator) : numerator(numerator), denominator(denominator)
+    {
+        if (denominator == 0)
+        {
+            raise(FractionError::ZeroDenominator, "constructor");
+        }
+
+        reduce();
+    }
+
+    template <typename Int>
+    constexpr Checked<BasicFraction<Int>> BasicFraction<Int>::make(Int num, Int den)
+    {
+        if (den == 0)
+        {
+            return FractionError::ZeroDenominator;
+        }
+        BasicFraction result;
+        result.numerator = num;
+        result.denominator = den;
+        FractionError error = result.normalize();
+        if (error != FractionError::None)
+        {
+            return error;
+        }
+        return result;
+    }
+
+    template <typename Int>
+    constexpr Checked<BasicFraction<Int>> BasicFraction<Int>::checkedFromDouble(double value)
+    {
+        constexpr int WIDTH = static_cast<int>(sizeof(Int) * 8);
+        constexpr int MANTISSA_BITS = 52;
+        constexpr int EXPONENT_BIAS = 1075; // 1023 plus the 52 fraction bits
+
+        auto bits = std::bit_cast<uint64_t>(value);
+        bool negative = (bits >> 63) != 0;
+        auto exponent = static_cast<int>((bits >> MANTISSA_BITS) & 0x7FF);
+        uint64_t mantissa = bits & ((uint64_t(1) << MANTISSA_BITS) - 1);
+        if (exponent == 0x7FF)
+        {
+            return FractionError::NotFinite;
+        }
+        if (exponent == 0)
+        {
+            if (mantissa == 0)
+            {
+                return BasicFraction();
+            }
+            exponent = 1; // subnormal: no implicit leading bit
+        }
+        else
+        {
+            mantissa |= uint64_t(1) << MANTISSA_BITS;
+        }
+        exponent -= EXPONENT_BIAS;
+
+        // value = mantissa * 2^exponent. Moving the trailing zeros into the exponent leaves
+        // an odd mantissa, which is coprime to any power-of-two denominator.
+        int zeros = trailingZeros(mantissa);
+        mantissa >>= zeros;
+        exponent += zeros;
+        int mantissa_width = 64 - leadingZeros(mantissa);
+
+        Unsigned limit = static_cast<Unsigned>(FractionTraits<Int>::max()) + Unsigned(negative ? 1 : 0);
+        Unsigned num = 0;
+        Unsigned den = 1;
+        if (exponent >= 0)
+        {
+            if (mantissa_width + exponent > WIDTH)
+            {
+                return FractionError::Overflow;
+            }
+            num = static_cast<Unsigned>(static_cast<Unsigned>(mantissa) << exponent);
+        }
+        else
+        {
+            // The largest power-of-two denominator is 2^(WIDTH - 2)
+            if (mantissa_width > WIDTH || -exponent > WIDTH - 2)
+            {
+                return FractionError::Overflow;
+            }
+            num = static_cast<Unsigned>(mantissa);
+            den = static_cast<Unsigned>(Unsigned(1) << -exponent);
+        }
+        if (num > limit)
+        {
+            return FractionError::Overflow;
+        }
+        BasicFraction result;
+        result.numerator = negative ? static_cast<Int>(Unsigned(0) - num) : static_cast<Int>(num);
+        result.denominator = static_cast<Int>(den);
+        return result;
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> BasicFraction<Int>::fromDouble(double value)
+    {
+        Checked<BasicFraction> result = checkedFromDouble(value);
+        if (!result)
+        {
+            raise(result.error(), "fromDouble");
+        }
+        return *result;
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> BasicFraction<Int>::approximate(double value, Int max_den)
+    {
+        using Big = unsigned __int128;
+        if (max_den < 1)
+        {
+            FRACTION_THROW(std::invalid_argument, "approximate needs a positive max_den");
+        }
+        Checked<BasicFraction> exact = checkedFromDouble(value);
+        if (exact.error() == FractionError::NotFinite)
+        {
+            raise(FractionError::NotFinite, "approximate");
+        }
+        if (exact && exact->denominator <= max_den)
+        {
+            return *exact;
+        }
+
+        // |value| = num / 2^shift with an odd num; whole values were handled above
+        auto bits = std::bit_cast<uint64_t>(value);
+        bool negative = (bits >> 63) != 0;
+        auto exponent = static_cast<int>((bits >> 52) & 0x7FF);
+        uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+        mantissa = exponent == 0 ? mantissa : mantissa | (uint64_t(1) << 52);
+        int shift = 1075 - (exponent == 0 ? 1 : exponent);
+        if (shift <= 0)
+        {
+            raise(FractionError::Overflow, "approximate");
+        }
+        Big num = mantissa;
+        if (shift > 127)
+        {
+            num >>= shift - 127;
+            shift = 127;
+        }
+        Big den = Big(1) << shift;
+        const Big scale = den;
+
+        Big num_limit = static_cast<Big>(FractionTraits<Int>::max()) + Big(negative ? 1 : 0);
+        auto den_limit = static_cast<Big>(max_den);
+        // Convergents h/k of num/den. The Euclid remainder den is |num*k1 - h1*scale| for
+        // the last convergent, which is all the final comparison needs.
+        Big prev_num = 0;
+        Big prev_den = 1;
+        Big last_num = 1;
+        Big last_den = 0;
+        while (den != 0)
+        {
+            Big quot = num / den;
+            Big next_num = 0;
+            Big next_den = 0;
+            bool fits = !__builtin_mul_overflow(quot, last_num, &next_num) && !__builtin_add_overflow(next_num, prev_num, &next_num) &&
+                        !__builtin_mul_overflow(quot, last_den, &next_den) && !__builtin_add_overflow(next_den, prev_den, &next_den) &&
+                        next_num <= num_limit && next_den <= den_limit;
+            if (!fits)
+            {
+                if (last_den == 0)
+                {
+                    // Even the integer part does not fit in Int
+                    raise(FractionError::Overflow, "approximate");
+                }
+                // Largest semiconvergent that still fits. It lies on the other side of value
+                // at distance 1/(k1*ks) from h1/k1, so it is closer exactly when
+                // 2*ks*|num*k1 - h1*scale| > scale.
+                Big steps = (den_limit - prev_den) / last_den;
+                if (last_num != 0)
+                {
+                    Big num_steps = (num_limit - prev_num) / last_num;
+                    steps = num_steps < steps ? num_steps : steps;
+                }
+                Big semi_den = steps * last_den + prev_den;
+                Big twice = 0;
+                if (steps != 0 && (__builtin_mul_overflow(semi_den, den, &twice) || __builtin_mul_overflow(twice, Big(2), &twice) || twice > scale))
+                {
+                    last_num = steps * last_num + prev_num;
+                    last_den = semi_den;
+                }
+                break;
+            }
+            prev_num = last_num;
+            prev_den = last_den;
+            last_num = next_num;
+            last_den = next_den;
+            Big rem = num - quot * den;
+            num = den;
+            den = rem;
+        }
+        BasicFraction result;
+        result.numerator = negative ? static_cast<Int>(Big(0) - last_num) : static_cast<Int>(last_num);
+        result.denominator = static_cast<Int>(last_den);
+        return result;
+    }
+
+    template <typename Int>
+    constexpr void BasicFraction<Int>::reduce()
+    {
+        FractionError error = normalize();
+        if (error != FractionError::None)
+        {
+            raise(error, "reduce");
+        }
+    }
+
+    template <typename Int>
+    constexpr FractionError BasicFraction<Int>::normalize()
+    {
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+
+        // Find the greatest common divisor of the numerator and denominator with the
+        // configured kernel (see Gcd.hpp). Working on the magnitudes keeps the most
+        // negative Int well defined. Whole numbers (den 1) are common enough, from
+        // Fraction(n) and parsed integers, to skip the kernel.
+        Unsigned num = magnitude(numerator);
+        Unsigned den = magnitude(denominator);
+        Unsigned gcd = den == 1 ? 1 : kernelGcd(num, den);
+        num /= gcd;
+        den /= gcd;
+
+        // Make sure the denominator is always positive
+        bool negative = (numerator < 0) != (denominator < 0);
+        if (den > static_cast<Unsigned>(FractionTraits<Int>::max()) ||
+            num > static_cast<Unsigned>(FractionTraits<Int>::max()) + Unsigned(negative ? 1 : 0))
+        {
+            return FractionError::Overflow;
+        }
+        numerator = negative ? static_cast<Int>(Unsigned(0) - num) : static_cast<Int>(num);
+        denominator = static_cast<Int>(den);
+        return FractionError::None;
+    }
+
+    template <typename Int>
+    constexpr Int BasicFraction<Int>::getNumerator() const
+    {
+        return numerator;
+    }
+
+    template <typename Int>
+    constexpr Int BasicFraction<Int>::getDenominator() const
+    {
+        return denominator;
+    }
+
+    // Henrici's addition. With g = gcd(b, d) and t = a*(d/g) +- c*(b/g), the sum is
+    // (t/g2) / ((b/g)*(d/g2)) where g2 = gcd(t, g). The result comes out reduced, the cross
+    // products are g times smaller than a*d and c*b, and the second gcd only sees values
+    // below g. Equal denominators (fixed-denominator feeds) skip the first gcd entirely.
+    // The products are exact in Wide for int and int64_t; for __int128 Wide is the same
+    // width, so the builtins are what catches an overflowing intermediate.
+    template <typename Int>
+    constexpr Checked<BasicFraction<Int>> BasicFraction<Int>::sum(const BasicFraction &other, const BasicFraction &frac, bool subtract)
+    {
+        using WideUnsigned = typename FractionTraits<Wide>::unsigned_type;
+
+        auto lhs_den = static_cast<Unsigned>(other.denominator);
+        auto rhs_den = static_cast<Unsigned>(frac.denominator);
+        Unsigned gcd = lhs_den == rhs_den ? lhs_den : kernelGcd(lhs_den, rhs_den);
+        auto lhs_scale = static_cast<Wide>(rhs_den / gcd);
+        auto rhs_scale = static_cast<Wide>(lhs_den / gcd);
+
+        Wide lhs = 0;
+        Wide rhs = 0;
+        Wide num = 0;
+        if (__builtin_mul_overflow(Wide(other.numerator), lhs_scale, &lhs) ||
+            __builtin_mul_overflow(Wide(frac.numerator), rhs_scale, &rhs) ||
+            (subtract ? __builtin_sub_overflow(lhs, rhs, &num) : __builtin_add_overflow(lhs, rhs, &num)))
+        {
+            return FractionError::Overflow;
+        }
+        if (num == 0)
+        {
+            return BasicFraction();
+        }
+
+        // gcd(t, g) == gcd(t mod g, g), which keeps the second gcd in the narrow type
+        Unsigned common = gcd == 1 ? 1 : kernelGcd(static_cast<Unsigned>(magnitude(num) % WideUnsigned(gcd)), gcd);
+        num /= static_cast<Wide>(common);
+        Wide den = 0;
+        Int small_num = 0;
+        Int small_den = 0;
+        if (__builtin_mul_overflow(rhs_scale, static_cast<Wide>(rhs_den / common), &den) ||
+            __builtin_add_overflow(num, Wide(0), &small_num) || __builtin_add_overflow(den, Wide(0), &small_den))
+        {
+            return FractionError::Overflow;
+        }
+        BasicFraction result;
+        result.numerator = small_num;
+        result.denominator = small_den;
+        return result;
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> BasicFraction<Int>::add(const BasicFraction &other, const BasicFraction &frac)
+    {
+        Checked<BasicFraction> result = sum(other, frac, false);
+        if (!result)
+        {
+            raise(result.error(), "operator+");
+        }
+        return *result;
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> BasicFraction<Int>::subtract(const BasicFraction &other, const BasicFraction &frac)
+    {
+        Checked<BasicFraction> result = sum(other, frac, true);
+        if (!result)
+        {
+            raise(result.error(), "operator-");
+        }
+        return *result;
+    }
+
+    // Build num_lhs*num_rhs / den_lhs*den_rhs from factors that are already coprime across
+    // the fraction bar, so the product needs no reduce() and only overflows when the
+    // reduced result itself does not fit in Int.
+    template <typename Int>
+    constexpr Checked<BasicFraction<Int>> BasicFraction<Int>::reducedProduct(Unsigned num_lhs, Unsigned num_rhs, Unsigned den_lhs, Unsigned den_rhs, bool negative)
+    {
+        Unsigned num = 0;
+        Unsigned den = 0;
+        auto limit = static_cast<Unsigned>(FractionTraits<Int>::max());
+        if (__builtin_mul_overflow(num_lhs, num_rhs, &num) || __builtin_mul_overflow(den_lhs, den_rhs, &den) ||
+            num > limit + Unsigned(negative ? 1 : 0) || den > limit)
+        {
+            return FractionError::Overflow;
+        }
+        BasicFraction result;
+        result.numerator = negative ? static_cast<Int>(Unsigned(0) - num) : static_cast<Int>(num);
+        result.denominator = static_cast<Int>(den);
+        return result;
+    }
+
+    // Both operands are reduced, so cancelling gcd(a, d) and gcd(c, b) before multiplying
+    // a/b * c/d leaves a reduced product with the smallest possible intermediates.
+    template <typename Int>
+    constexpr Checked<BasicFraction<Int>> BasicFraction<Int>::product(const BasicFraction &other, const BasicFraction &frac)
+    {
+        if (other.numerator == 0 || frac.numerator == 0)
+        {
+            return BasicFraction();
+        }
+        Unsigned lhs_num = magnitude(other.numerator);
+        Unsigned rhs_num = magnitude(frac.numerator);
+        auto lhs_den = static_cast<Unsigned>(other.denominator);
+        auto rhs_den = static_cast<Unsigned>(frac.denominator);
+        Unsigned cross_lhs = kernelGcd(lhs_num, rhs_den);
+        Unsigned cross_rhs = kernelGcd(rhs_num, lhs_den);
+        return reducedProduct(lhs_num / cross_lhs, rhs_num / cross_rhs, lhs_den / cross_rhs, rhs_den / cross_lhs,
+                              (other.numerator < 0) != (frac.numerator < 0));
+    }
+
+    // a/b / c/d is a*d / b*c, cancelled with gcd(a, c) and gcd(b, d) the same way
+    template <typename Int>
+    constexpr Checked<BasicFraction<Int>> BasicFraction<Int>::quotient(const BasicFraction &other, const BasicFraction &frac)
+    {
+        if (frac.numerator == 0)
+        {
+            return FractionError::DivideByZero;
+        }
+        if (other.numerator == 0)
+        {
+            return BasicFraction();
+        }
+        Unsigned lhs_num = magnitude(other.numerator);
+        Unsigned rhs_num = magnitude(frac.numerator);
+        auto lhs_den = static_cast<Unsigned>(other.denominator);
+        auto rhs_den = static_cast<Unsigned>(frac.denominator);
+        Unsigned cross_num = kernelGcd(lhs_num, rhs_num);
+        Unsigned cross_den = kernelGcd(lhs_den, rhs_den);
+        return reducedProduct(lhs_num / cross_num, rhs_den / cross_den, lhs_den / cross_den, rhs_num / cross_num,
+                              (other.numerator < 0) != (frac.numerator < 0));
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> BasicFraction<Int>::multiply(const BasicFraction &other, const BasicFraction &frac)
+    {
+        Checked<BasicFraction> result = product(other, frac);
+        if (!result)
+        {
+            raise(result.error(), "operator*");
+        }
+        return *result;
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> BasicFraction<Int>::divide(const BasicFraction &other, const BasicFraction &frac)
+    {
+        Checked<BasicFraction> result = quotient(other, frac);
+        if (!result)
+        {
+            raise(result.error(), "operator/");
+        }
+        return *result;
+    }
+
+    template <typename Int>
+    constexpr std::strong_ordering BasicFraction<Int>::compare(const BasicFraction &other, const BasicFraction &frac)
+    {
+        // Denominators are positive, so cross-multiplying keeps the order. When Wide is
+        // twice as wide the products always fit, and the plain multiply is branch-free:
+        // sign or integer-part tests only add mispredicted branches on mixed data.
+        if constexpr (sizeof(Wide) >= 2 * sizeof(Int))
+        {
+            return Wide(other.numerator) * Wide(frac.denominator) <=> Wide(frac.numerator) * Wide(other.denominator);
+        }
+        else
+        {
+            // Different signs (or a zero) decide without touching the denominators
+            int lhs_sign = (other.numerator > 0) - (other.numerator < 0);
+            int rhs_sign = (frac.numerator > 0) - (frac.numerator < 0);
+            if (lhs_sign != rhs_sign || lhs_sign == 0)
+            {
+                return lhs_sign <=> rhs_sign;
+            }
+            // Operands that fit in 64 bits multiply exactly, as in the narrower backends
+            auto fits64 = [](Int value)
+            { return static_cast<int64_t>(value) == value; };
+            if (fits64(other.numerator) && fits64(other.denominator) && fits64(frac.numerator) && fits64(frac.denominator))
+            {
+                return Wide(other.numerator) * Wide(frac.denominator) <=> Wide(frac.numerator) * Wide(other.denominator);
+            }
+            // Wider ones go through the 128-bit overflow checks and possibly the continued
+            // fractions below, so first try the products as doubles. Each is within 2^-51
+            // of the exact value; anything further apart than 2^-48 is decided.
+            double lhs_approx = approximateDouble(other.numerator) * approximateDouble(frac.denominator);
+            double rhs_approx = approximateDouble(frac.numerator) * approximateDouble(other.denominator);
+            double bound = (std::abs(lhs_approx) + std::abs(rhs_approx)) * 0x1p-48;
+            if (lhs_approx - rhs_approx > bound)
+            {
+                return std::strong_ordering::greater;
+            }
+            if (rhs_approx - lhs_approx > bound)
+            {
+                return std::strong_ordering::less;
+            }
+            Wide lhs = 0;
+            Wide rhs = 0;
+            if (!__builtin_mul_overflow(other.numerator, frac.denominator, &lhs) &&
+                !__builtin_mul_overflow(frac.numerator, other.denominator, &rhs))
+            {
+                return lhs <=> rhs;
+            }
+            std::strong_ordering order = compareMagnitudes(magnitude(other.numerator), static_cast<Unsigned>(other.denominator),
+                                                           magnitude(frac.numerator), static_cast<Unsigned>(frac.denominator));
+            return lhs_sign > 0 ? order : 0 <=> order;
+        }
+    }
+
+    // Overflow-free order of a/b and c/d (b, d > 0) for the widest backend: compare the
+    // integer parts, and on a tie the remainders through their reciprocals, which swaps
+    // the order. This walks the two continued fractions in step.
+    template <typename Int>
+    constexpr std::strong_ordering BasicFraction<Int>::compareMagnitudes(Unsigned lhs_num, Unsigned lhs_den, Unsigned rhs_num, Unsigned rhs_den)
+    {
+        bool swapped = false;
+        while (true)
+        {
+            Unsigned lhs_whole = lhs_num / lhs_den;
+            Unsigned rhs_whole = rhs_num / rhs_den;
+            std::strong_ordering order = lhs_whole <=> rhs_whole;
+            if (order == 0)
+            {
+                Unsigned lhs_rem = lhs_num % lhs_den;
+                Unsigned rhs_rem = rhs_num % rhs_den;
+                if (lhs_rem == 0 || rhs_rem == 0)
+                {
+                    order = (rhs_rem == 0) <=> (lhs_rem == 0);
+                }
+                else
+                {
+                    lhs_num = lhs_den;
+                    lhs_den = lhs_rem;
+                    rhs_num = rhs_den;
+                    rhs_den = rhs_rem;
+                    swapped = !swapped;
+                    continue;
+                }
+            }
+            return swapped ? 0 <=> order : order;
+        }
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> &BasicFraction<Int>::operator++()
+    {
+        numerator += denominator;
+        return *this;
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> BasicFraction<Int>::operator++(int)
+    {
+        BasicFraction t(*this);
+        numerator += denominator;
+        return t;
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> &BasicFraction<Int>::operator--()
+    {
+        numerator -= denominator;
+        return *this;
+    }
+
+    template <typename Int>
+    constexpr BasicFraction<Int> BasicFraction<Int>::operator--(int)
+    {
+        BasicFraction t(*this);
+        numerator -= denominator;
+        return t;
+    }
+
+    template <typename Int>
+    std::ostream &operator<<(std::ostream &ost, const BasicFraction<Int> &frac);
+    template <typename Int>
+    std::istream &operator>>(std::istream &ist, BasicFraction<Int> &frac);
+
+    using Fraction = BasicFraction<int>;
+    using Fraction64 = BasicFraction<int64_t>;
+    using Fraction128 = BasicFraction<__int128>;
+
+    // 64-bit finalizer (MurmurHash3's fmix64): every input bit flips each output bit with
+    // probability close to 1/2, so masking off the low bits gives a usable table index
+    constexpr uint64_t mixHash(uint64_t value)
+    {
+        value = (value ^ (value >> 33)) * 0xff51afd7ed558ccdULL;
+        value = (value ^ (value >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+        return value ^ (value >> 33);
+    }
+
+    // Hash of the reduced (numerator, denominator) pair. Values are always reduced with a
+    // positive denominator, so equal fractions have equal fields and equal hashes. For
+    // int both fields pack into one word, and distinct fractions never collide before
+    // the table masks the hash.
+    template <typename Int>
+    constexpr size_t hashValue(const BasicFraction<Int> &frac)
+    {
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+        auto num = static_cast<Unsigned>(frac.getNumerator());
+        auto den = static_cast<Unsigned>(frac.getDenominator());
+        if constexpr (sizeof(Int) <= 4)
+        {
+            return static_cast<size_t>(mixHash(static_cast<uint64_t>(num) << 32 | den));
+        }
+        else
+        {
+            auto fold = [](Unsigned value)
+            {
+                if constexpr (sizeof(Unsigned) > 8)
+                {
+                    return static_cast<uint64_t>(value) ^ mixHash(static_cast<uint64_t>(value >> 64));
+                }
+                else
+                {
+                    return static_cast<uint64_t>(value);
+                }
+            };
+            return static_cast<size_t>(mixHash(fold(num) ^ mixHash(fold(den))));
+        }
+    }
+
+#ifndef FRACTION_HEADER_ONLY
+    extern template class BasicFraction<int>;
+    extern template class BasicFraction<int64_t>;
+    extern template class BasicFraction<__int128>;
+#endif
 }
 
+// Lets fractions key std::unordered_map and std::unordered_set directly
+template <typename Int>
+struct std::hash<ariel::BasicFraction<Int>>
+{
+    constexpr size_t operator()(const ariel::BasicFraction<Int> &frac) const noexcept { return ariel::hashValue(frac); }
+};
+
+// Header-only mode (-DFRACTION_HEADER_ONLY, or make HEADER_ONLY=1): every definition is
+// visible to the caller, so the whole library can be inlined into caller loops
+#ifdef FRACTION_HEADER_ONLY
+#include "FractionImpl.hpp"
+#endif
+
 #endif // FRACTION_HPP
@@ -0,0 +1,738 @@
+#include "FractionArray.hpp"
+#include "Gcd.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FRACTION_ARRAY_X86 1
+#endif
+
+using namespace std;
+
+namespace ariel
+{
+
+    namespace
+    {
+        enum class Op
+        {
+            Add,
+            Subtract,
+            Multiply,
+            Divide
+        };
+
+        const char *operatorName(Op op)
+        {
+            switch (op)
+            {
+            case Op::Add:
+                return "operator+";
+            case Op::Subtract:
+                return "operator-";
+            case Op::Multiply:
+                return "operator*";
+            case Op::Divide:
+            default:
+                return "operator/";
+            }
+        }
+
+        SimdLevel detectSimdLevel()
+        {
+#ifdef FRACTION_ARRAY_X86
+            if (__builtin_cpu_supports("avx2"))
+            {
+                return SimdLevel::AVX2;
+            }
+            if (__builtin_cpu_supports("sse4.2"))
+            {
+                return SimdLevel::SSE42;
+            }
+#endif
+            return SimdLevel::Scalar;
+        }
+
+        std::atomic<SimdLevel> &activeLevel()
+        {
+            static std::atomic<SimdLevel> level(detectSimdLevel());
+            return level;
+        }
+
+        // Unreduced a/b op c/d in 64-bit lanes. Every product of two int values fits in
+        // int64_t, and so does the sum of two of them.
+        template <Op op>
+        void crossScalar(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                         int64_t *num, int64_t *den, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                int64_t a = lhs_num[i];
+                int64_t b = lhs_den[i];
+                int64_t c = rhs_num[i];
+                int64_t d = rhs_den[i];
+                if constexpr (op == Op::Add)
+                {
+                    num[i] = a * d + c * b;
+                    den[i] = b * d;
+                }
+                else if constexpr (op == Op::Subtract)
+                {
+                    num[i] = a * d - c * b;
+                    den[i] = b * d;
+                }
+                else if constexpr (op == Op::Multiply)
+                {
+                    num[i] = a * c;
+                    den[i] = b * d;
+                }
+                else
+                {
+                    num[i] = a * d;
+                    den[i] = b * c;
+                }
+            }
+        }
+
+        // a*d < c*b per element; denominators of reduced values are positive
+        void lessScalar(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                        uint8_t *out, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                out[i] = static_cast<uint8_t>(int64_t(lhs_num[i]) * rhs_den[i] < int64_t(rhs_num[i]) * lhs_den[i]);
+            }
+        }
+
+        // Reduced values are equal exactly when both components are
+        void equalScalar(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                         uint8_t *out, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                out[i] = static_cast<uint8_t>(lhs_num[i] == rhs_num[i] && lhs_den[i] == rhs_den[i]);
+            }
+        }
+
+#ifdef FRACTION_ARRAY_X86
+        // _mm*_mul_epi32 multiplies the sign-extended low halves of each 64-bit lane, so the
+        // int columns are widened with cvtepi32_epi64 and every product is exact.
+        template <Op op>
+        __attribute__((target("avx2"))) void crossAvx2(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                                                       int64_t *num, int64_t *den, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256i a = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs_num + i)));
+                __m256i b = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs_den + i)));
+                __m256i c = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs_num + i)));
+                __m256i d = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs_den + i)));
+                __m256i out_num;
+                __m256i out_den;
+                if constexpr (op == Op::Add)
+                {
+                    out_num = _mm256_add_epi64(_mm256_mul_epi32(a, d), _mm256_mul_epi32(c, b));
+                    out_den = _mm256_mul_epi32(b, d);
+                }
+                else if constexpr (op == Op::Subtract)
+                {
+                    out_num = _mm256_sub_epi64(_mm256_mul_epi32(a, d), _mm256_mul_epi32(c, b));
+                    out_den = _mm256_mul_epi32(b, d);
+                }
+                else if constexpr (op == Op::Multiply)
+                {
+                    out_num = _mm256_mul_epi32(a, c);
+                    out_den = _mm256_mul_epi32(b, d);
+                }
+                else
+                {
+                    out_num = _mm256_mul_epi32(a, d);
+                    out_den = _mm256_mul_epi32(b, c);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(num + i), out_num);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(den + i), out_den);
+            }
+            crossScalar<op>(lhs_num, lhs_den, rhs_num, rhs_den, num, den, i, count);
+        }
+
+        template <Op op>
+        __attribute__((target("sse4.2"))) void crossSse42(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                                                          int64_t *num, int64_t *den, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                __m128i a = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(lhs_num + i)));
+                __m128i b = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(lhs_den + i)));
+                __m128i c = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(rhs_num + i)));
+                __m128i d = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(rhs_den + i)));
+                __m128i out_num;
+                __m128i out_den;
+                if constexpr (op == Op::Add)
+                {
+                    out_num = _mm_add_epi64(_mm_mul_epi32(a, d), _mm_mul_epi32(c, b));
+                    out_den = _mm_mul_epi32(b, d);
+                }
+                else if constexpr (op == Op::Subtract)
+                {
+                    out_num = _mm_sub_epi64(_mm_mul_epi32(a, d), _mm_mul_epi32(c, b));
+                    out_den = _mm_mul_epi32(b, d);
+                }
+                else if constexpr (op == Op::Multiply)
+                {
+                    out_num = _mm_mul_epi32(a, c);
+                    out_den = _mm_mul_epi32(b, d);
+                }
+                else
+                {
+                    out_num = _mm_mul_epi32(a, d);
+                    out_den = _mm_mul_epi32(b, c);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(num + i), out_num);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(den + i), out_den);
+            }
+            crossScalar<op>(lhs_num, lhs_den, rhs_num, rhs_den, num, den, i, count);
+        }
+
+        __attribute__((target("avx2"))) void lessAvx2(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                                                      uint8_t *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256i a = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs_num + i)));
+                __m256i b = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs_den + i)));
+                __m256i c = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs_num + i)));
+                __m256i d = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs_den + i)));
+                __m256i less = _mm256_cmpgt_epi64(_mm256_mul_epi32(c, b), _mm256_mul_epi32(a, d));
+                int bits = _mm256_movemask_pd(_mm256_castsi256_pd(less));
+                for (size_t lane = 0; lane < 4; ++lane)
+                {
+                    out[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+                }
+            }
+            lessScalar(lhs_num, lhs_den, rhs_num, rhs_den, out, i, count);
+        }
+
+        __attribute__((target("sse4.2"))) void lessSse42(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                                                         uint8_t *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                __m128i a = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(lhs_num + i)));
+                __m128i b = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(lhs_den + i)));
+                __m128i c = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(rhs_num + i)));
+                __m128i d = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(rhs_den + i)));
+                __m128i less = _mm_cmpgt_epi64(_mm_mul_epi32(c, b), _mm_mul_epi32(a, d));
+                int bits = _mm_movemask_pd(_mm_castsi128_pd(less));
+                out[i] = static_cast<uint8_t>(bits & 1);
+                out[i + 1] = static_cast<uint8_t>((bits >> 1) & 1);
+            }
+            lessScalar(lhs_num, lhs_den, rhs_num, rhs_den, out, i, count);
+        }
+
+        __attribute__((target("avx2"))) void equalAvx2(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                                                       uint8_t *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i same_num = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs_num + i)),
+                                                      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs_num + i)));
+                __m256i same_den = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs_den + i)),
+                                                      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs_den + i)));
+                int bits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(same_num, same_den)));
+                for (size_t lane = 0; lane < 8; ++lane)
+                {
+                    out[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+                }
+            }
+            equalScalar(lhs_num, lhs_den, rhs_num, rhs_den, out, i, count);
+        }
+
+        __attribute__((target("sse4.2"))) void equalSse42(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                                                          uint8_t *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i same_num = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs_num + i)),
+                                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs_num + i)));
+                __m128i same_den = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs_den + i)),
+                                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs_den + i)));
+                int bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(same_num, same_den)));
+                for (size_t lane = 0; lane < 4; ++lane)
+                {
+                    out[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+                }
+            }
+            equalScalar(lhs_num, lhs_den, rhs_num, rhs_den, out, i, count);
+        }
+#endif
+
+        // A lane needs the exact scalar path when the constructor would throw or when its
+        // magnitudes do not fit the signed lanes: zero or INT_MIN denominators, and an
+        // INT_MIN numerator whose sign has to move
+        bool needsScalar(int num, int den)
+        {
+            return den == 0 || den == std::numeric_limits<int>::min() || (num == std::numeric_limits<int>::min() && den < 0);
+        }
+
+        void gcdScalar(const uint32_t *lhs, const uint32_t *rhs, uint32_t *out, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                out[i] = steinGcd(lhs[i], rhs[i]);
+            }
+        }
+
+        void reduceScalar(int *nums, int *dens, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (needsScalar(nums[i], dens[i]))
+                {
+                    Fraction frac(nums[i], dens[i]);
+                    nums[i] = frac.getNumerator();
+                    dens[i] = frac.getDenominator();
+                    continue;
+                }
+                uint32_t num_mag = nums[i] < 0 ? 0U - static_cast<uint32_t>(nums[i]) : static_cast<uint32_t>(nums[i]);
+                uint32_t den_mag = dens[i] < 0 ? 0U - static_cast<uint32_t>(dens[i]) : static_cast<uint32_t>(dens[i]);
+                // gcd <= |den| <= INT_MAX here, so the signed divisions are exact
+                auto gcd = static_cast<int>(steinGcd(num_mag, den_mag));
+                int num = nums[i] / gcd;
+                int den = dens[i] / gcd;
+                nums[i] = den < 0 ? -num : num;
+                dens[i] = den < 0 ? -den : den;
+            }
+        }
+
+#ifdef FRACTION_ARRAY_X86
+        // Trailing zeros of every 32-bit lane: isolate the lowest set bit and read its
+        // exponent back from the float conversion (exact, since it is a power of two)
+        __attribute__((target("avx2"))) __m256i trailingZeros8(__m256i value)
+        {
+            __m256i low = _mm256_and_si256(value, _mm256_sub_epi32(_mm256_setzero_si256(), value));
+            __m256i bits = _mm256_castps_si256(_mm256_cvtepi32_ps(low));
+            return _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xFF)), _mm256_set1_epi32(127));
+        }
+
+        // Stein's algorithm on eight lanes at once. Every iteration strips the trailing zeros
+        // of v, orders the pair with unsigned min/max and subtracts; lanes whose v reached
+        // zero are frozen until the slowest lane finishes.
+        __attribute__((target("avx2"))) __m256i gcd8(__m256i lhs, __m256i rhs)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            // gcd(0, v) = v and gcd(u, 0) = u
+            lhs = _mm256_blendv_epi8(lhs, rhs, _mm256_cmpeq_epi32(lhs, zero));
+            rhs = _mm256_blendv_epi8(rhs, lhs, _mm256_cmpeq_epi32(rhs, zero));
+            __m256i shift = trailingZeros8(_mm256_or_si256(lhs, rhs));
+            lhs = _mm256_srlv_epi32(lhs, trailingZeros8(lhs));
+            __m256i done = _mm256_cmpeq_epi32(rhs, zero);
+            while (_mm256_movemask_ps(_mm256_castsi256_ps(done)) != 0xFF)
+            {
+                rhs = _mm256_srlv_epi32(rhs, trailingZeros8(rhs));
+                __m256i low = _mm256_min_epu32(lhs, rhs);
+                __m256i high = _mm256_max_epu32(lhs, rhs);
+                lhs = _mm256_blendv_epi8(low, lhs, done);
+                rhs = _mm256_andnot_si256(done, _mm256_sub_epi32(high, low));
+                done = _mm256_cmpeq_epi32(rhs, zero);
+            }
+            return _mm256_sllv_epi32(lhs, shift);
+        }
+
+        // Exact signed division of eight lanes by divisors that divide them: both fit in a
+        // double without rounding, so the quotient of the conversion is exact too
+        __attribute__((target("avx2"))) __m256i divideExact8(__m256i value, __m256i divisor)
+        {
+            __m256d value_low = _mm256_cvtepi32_pd(_mm256_castsi256_si128(value));
+            __m256d value_high = _mm256_cvtepi32_pd(_mm256_extracti128_si256(value, 1));
+            __m256d divisor_low = _mm256_cvtepi32_pd(_mm256_castsi256_si128(divisor));
+            __m256d divisor_high = _mm256_cvtepi32_pd(_mm256_extracti128_si256(divisor, 1));
+            __m128i quot_low = _mm256_cvttpd_epi32(_mm256_div_pd(value_low, divisor_low));
+            __m128i quot_high = _mm256_cvttpd_epi32(_mm256_div_pd(value_high, divisor_high));
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(quot_low), quot_high, 1);
+        }
+
+        __attribute__((target("avx2"))) void gcdAvx2(const uint32_t *lhs, const uint32_t *rhs, uint32_t *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i gcd = gcd8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i)),
+                                   _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), gcd);
+            }
+            gcdScalar(lhs, rhs, out, i, count);
+        }
+
+        // Reduce eight lanes that need no scalar fallback (see needsScalar) and move the
+        // signs to the numerators
+        __attribute__((target("avx2"))) void reduce8(__m256i &num, __m256i &den)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            // abs(INT_MIN) stays 0x80000000, which is the right unsigned magnitude
+            __m256i gcd = gcd8(_mm256_abs_epi32(num), _mm256_abs_epi32(den));
+            num = divideExact8(num, gcd);
+            den = divideExact8(den, gcd);
+            num = _mm256_blendv_epi8(num, _mm256_sub_epi32(zero, num), _mm256_cmpgt_epi32(zero, den));
+            den = _mm256_abs_epi32(den);
+        }
+
+        __attribute__((target("avx2"))) void reduceAvx2(int *nums, int *dens, size_t count)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i int_min = _mm256_set1_epi32(std::numeric_limits<int>::min());
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i num = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(nums + i));
+                __m256i den = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dens + i));
+                __m256i negative_den = _mm256_cmpgt_epi32(zero, den);
+                __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi32(den, zero), _mm256_cmpeq_epi32(den, int_min)),
+                                                  _mm256_and_si256(_mm256_cmpeq_epi32(num, int_min), negative_den));
+                if (_mm256_testz_si256(special, special) == 0)
+                {
+                    reduceScalar(nums, dens, i, i + 8);
+                    continue;
+                }
+                reduce8(num, den);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(nums + i), num);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dens + i), den);
+            }
+            reduceScalar(nums, dens, i, count);
+        }
+#endif
+
+        template <Op op>
+        void cross(const int *lhs_num, const int *lhs_den, const int *rhs_num, const int *rhs_den,
+                   int64_t *num, int64_t *den, size_t count)
+        {
+#ifdef FRACTION_ARRAY_X86
+            switch (simdLevel())
+            {
+            case SimdLevel::AVX2:
+                crossAvx2<op>(lhs_num, lhs_den, rhs_num, rhs_den, num, den, count);
+                return;
+            case SimdLevel::SSE42:
+                crossSse42<op>(lhs_num, lhs_den, rhs_num, rhs_den, num, den, count);
+                return;
+            default:
+                break;
+            }
+#endif
+            crossScalar<op>(lhs_num, lhs_den, rhs_num, rhs_den, num, den, 0, count);
+        }
+
+        // Reduce 64-bit intermediates and narrow them back into the int columns. The
+        // reduced form is unique, so this matches whatever path the scalar operator took,
+        // and it overflows exactly when the scalar operator would.
+        void reduceNarrowScalar(const int64_t *num, const int64_t *den, int *out_num, int *out_den, size_t begin, size_t end, const char *what)
+        {
+            const auto limit = static_cast<uint64_t>(std::numeric_limits<int>::max());
+            for (size_t i = begin; i < end; ++i)
+            {
+                uint64_t num_mag = num[i] < 0 ? 0 - static_cast<uint64_t>(num[i]) : static_cast<uint64_t>(num[i]);
+                uint64_t den_mag = den[i] < 0 ? 0 - static_cast<uint64_t>(den[i]) : static_cast<uint64_t>(den[i]);
+                uint64_t gcd = kernelGcd(num_mag, den_mag);
+                num_mag /= gcd;
+                den_mag /= gcd;
+                bool negative = (num[i] < 0) != (den[i] < 0);
+                if (den_mag > limit || num_mag > limit + (negative ? 1U : 0U))
+                {
+                    FRACTION_THROW(std::overflow_error, std::string("Overflow in ") + what);
+                }
+                out_num[i] = negative ? static_cast<int>(0 - static_cast<int64_t>(num_mag)) : static_cast<int>(num_mag);
+                out_den[i] = static_cast<int>(den_mag);
+            }
+        }
+
+#ifdef FRACTION_ARRAY_X86
+        // Low halves of eight 64-bit lanes, in order
+        __attribute__((target("avx2"))) __m256i narrow8(const int64_t *values)
+        {
+            const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+            __m256i low = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)), low_halves);
+            __m256i high = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + 4)), low_halves);
+            return _mm256_permute2x128_si256(low, high, 0x20);
+        }
+
+        // Bit per lane of four 64-bit lanes outside [-INT_MAX, INT_MAX]
+        __attribute__((target("avx2"))) int outsideInt4(const int64_t *values)
+        {
+            const __m256i high = _mm256_set1_epi64x(std::numeric_limits<int>::max());
+            const __m256i low = _mm256_set1_epi64x(-std::numeric_limits<int>::max());
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(value, high), _mm256_cmpgt_epi64(low, value));
+            return _mm256_movemask_pd(_mm256_castsi256_pd(outside));
+        }
+
+        // Lanes whose intermediates fit in int (the common case for small operands) are
+        // narrowed first and reduced eight at a time by gcd8. They cannot overflow: the
+        // reduced magnitudes only shrink. Wider lanes take the scalar 64-bit path.
+        __attribute__((target("avx2"))) void reduceNarrowAvx2(const int64_t *num, const int64_t *den, int *out_num, int *out_den, size_t count, const char *what)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                int wide = outsideInt4(num + i) | outsideInt4(den + i) | (outsideInt4(num + i + 4) | outsideInt4(den + i + 4)) << 4;
+                if (wide == 0xFF)
+                {
+                    reduceNarrowScalar(num, den, out_num, out_den, i, i + 8, what);
+                    continue;
+                }
+                __m256i narrow_num = narrow8(num + i);
+                __m256i narrow_den = narrow8(den + i);
+                reduce8(narrow_num, narrow_den);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out_num + i), narrow_num);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out_den + i), narrow_den);
+                for (size_t lane = 0; wide != 0 && lane < 8; ++lane)
+                {
+                    if (((wide >> lane) & 1) != 0)
+                    {
+                        reduceNarrowScalar(num, den, out_num, out_den, i + lane, i + lane + 1, what);
+                    }
+                }
+            }
+            reduceNarrowScalar(num, den, out_num, out_den, i, count, what);
+        }
+#endif
+
+        void reduceNarrow(const int64_t *num, const int64_t *den, int *out_num, int *out_den, size_t count, const char *what)
+        {
+#ifdef FRACTION_ARRAY_X86
+            if (simdLevel() == SimdLevel::AVX2)
+            {
+                reduceNarrowAvx2(num, den, out_num, out_den, count, what);
+                return;
+            }
+#endif
+            reduceNarrowScalar(num, den, out_num, out_den, 0, count, what);
+        }
+
+        void checkSizes(const FractionArray &other, const FractionArray &frac)
+        {
+            if (other.size() != frac.size())
+            {
+                FRACTION_THROW(std::invalid_argument, "FractionArray sizes differ");
+            }
+        }
+
+        template <Op op>
+        FractionArray apply(const FractionArray &other, const FractionArray &frac)
+        {
+            checkSizes(other, frac);
+            size_t count = other.size();
+            if constexpr (op == Op::Divide)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (frac.numerators()[i] == 0)
+                    {
+                        FRACTION_THROW(std::runtime_error, "Denominator cannot be zero");
+                    }
+                }
+            }
+            std::vector<int64_t, AlignedAllocator<int64_t, 32>> num(count);
+            std::vector<int64_t, AlignedAllocator<int64_t, 32>> den(count);
+            cross<op>(other.numerators(), other.denominators(), frac.numerators(), frac.denominators(), num.data(), den.data(), count);
+            FractionArray result(count);
+            reduceNarrow(num.data(), den.data(), result.numerators(), result.denominators(), count, operatorName(op));
+            return result;
+        }
+
+        FractionArray::Mask lessMask(const FractionArray &other, const FractionArray &frac)
+        {
+            checkSizes(other, frac);
+            FractionArray::Mask out(other.size());
+#ifdef FRACTION_ARRAY_X86
+            switch (simdLevel())
+            {
+            case SimdLevel::AVX2:
+                lessAvx2(other.numerators(), other.denominators(), frac.numerators(), frac.denominators(), out.data(), out.size());
+                return out;
+            case SimdLevel::SSE42:
+                lessSse42(other.numerators(), other.denominators(), frac.numerators(), frac.denominators(), out.data(), out.size());
+                return out;
+            default:
+                break;
+            }
+#endif
+            lessScalar(other.numerators(), other.denominators(), frac.numerators(), frac.denominators(), out.data(), 0, out.size());
+            return out;
+        }
+
+        FractionArray::Mask equalMask(const FractionArray &other, const FractionArray &frac)
+        {
+            checkSizes(other, frac);
+            FractionArray::Mask out(other.size());
+#ifdef FRACTION_ARRAY_X86
+            switch (simdLevel())
+            {
+            case SimdLevel::AVX2:
+                equalAvx2(other.numerators(), other.denominators(), frac.numerators(), frac.denominators(), out.data(), out.size());
+                return out;
+            case SimdLevel::SSE42:
+                equalSse42(other.numerators(), other.denominators(), frac.numerators(), frac.denominators(), out.data(), out.size());
+                return out;
+            default:
+                break;
+            }
+#endif
+            equalScalar(other.numerators(), other.denominators(), frac.numerators(), frac.denominators(), out.data(), 0, out.size());
+            return out;
+        }
+
+        FractionArray::Mask negate(FractionArray::Mask mask)
+        {
+            for (uint8_t &bit : mask)
+            {
+                bit ^= 1U;
+            }
+            return mask;
+        }
+    }
+
+    SimdLevel simdLevel()
+    {
+        return activeLevel().load(std::memory_order_relaxed);
+    }
+
+    // Never goes above what the CPU supports; returns the level actually in effect
+    SimdLevel setSimdLevel(SimdLevel level)
+    {
+        SimdLevel supported = detectSimdLevel();
+        SimdLevel effective = static_cast<int>(level) <= static_cast<int>(supported) ? level : supported;
+        activeLevel().store(effective, std::memory_order_relaxed);
+        return effective;
+    }
+
+    void gcdBatch(const uint32_t *lhs, const uint32_t *rhs, uint32_t *out, size_t count)
+    {
+#ifdef FRACTION_ARRAY_X86
+        if (simdLevel() == SimdLevel::AVX2)
+        {
+            gcdAvx2(lhs, rhs, out, count);
+            return;
+        }
+#endif
+        gcdScalar(lhs, rhs, out, 0, count);
+    }
+
+    void reduceBatch(int *nums, int *dens, size_t count)
+    {
+#ifdef FRACTION_ARRAY_X86
+        if (simdLevel() == SimdLevel::AVX2)
+        {
+            reduceAvx2(nums, dens, count);
+            return;
+        }
+#endif
+        reduceScalar(nums, dens, 0, count);
+    }
+
+    FractionArray::FractionArray(size_t count) : numerator(count, 0), denominator(count, 1)
+    {
+    }
+
+    FractionArray::FractionArray(const std::vector<Fraction> &values)
+    {
+        numerator.reserve(values.size());
+        denominator.reserve(values.size());
+        for (const Fraction &frac : values)
+        {
+            push_back(frac);
+        }
+    }
+
+    // The columns are kept reduced, so elements are read back without a gcd
+    Fraction FractionArray::operator[](size_t index) const
+    {
+        return Fraction::fromReduced(ReducedKey(), numerator.at(index), denominator.at(index));
+    }
+
+    void FractionArray::set(size_t index, const Fraction &frac)
+    {
+        numerator.at(index) = frac.getNumerator();
+        denominator.at(index) = frac.getDenominator();
+    }
+
+    void FractionArray::push_back(const Fraction &frac)
+    {
+        numerator.push_back(frac.getNumerator());
+        denominator.push_back(frac.getDenominator());
+    }
+
+    std::vector<Fraction> FractionArray::toVector() const
+    {
+        std::vector<Fraction> values;
+        values.reserve(size());
+        for (size_t i = 0; i < size(); ++i)
+        {
+            values.push_back(Fraction::fromReduced(ReducedKey(), numerator[i], denominator[i]));
+        }
+        return values;
+    }
+
+    // Normalize every element the way the Fraction constructor does
+    void FractionArray::reduce()
+    {
+        reduceBatch(numerator.data(), denominator.data(), size());
+    }
+
+    FractionArray operator+(const FractionArray &other, const FractionArray &frac)
+    {
+        return apply<Op::Add>(other, frac);
+    }
+
+    FractionArray operator-(const FractionArray &other, const FractionArray &frac)
+    {
+        return apply<Op::Subtract>(other, frac);
+    }
+
+    FractionArray operator*(const FractionArray &other, const FractionArray &frac)
+    {
+        return apply<Op::Multiply>(other, frac);
+    }
+
+    FractionArray operator/(const FractionArray &other, const FractionArray &frac)
+    {
+        return apply<Op::Divide>(other, frac);
+    }
+
+    FractionArray::Mask operator==(const FractionArray &other, const FractionArray &frac)
+    {
+        return equalMask(other, frac);
+    }
+
+    FractionArray::Mask operator!=(const FractionArray &other, const FractionArray &frac)
+    {
+        return negate(equalMask(other, frac));
+    }
+
+    FractionArray::Mask operator<(const FractionArray &other, const FractionArray &frac)
+    {
+        return lessMask(other, frac);
+    }
+
+    FractionArray::Mask operator>(const FractionArray &other, const FractionArray &frac)
+    {
+        return lessMask(frac, other);
+    }
+
+    FractionArray::Mask operator<=(const FractionArray &other, const FractionArray &frac)
+    {
+        return negate(lessMask(frac, other));
+    }
+
+    FractionArray::Mask operator>=(const FractionArray &other, const FractionArray &frac)
+    {
+        return negate(lessMask(other, frac));
+    }
+
+}
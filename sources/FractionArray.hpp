@@ -0,0 +1,118 @@
+#ifndef FRACTIONARRAY_HPP
+#define FRACTIONARRAY_HPP
+
+#include "Fraction.hpp"
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ariel
+{
+    // Minimal allocator that hands out storage aligned for 256-bit vector loads
+    template <typename T, size_t Alignment>
+    struct AlignedAllocator
+    {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> & /*other*/) {}
+
+        T *allocate(size_t count)
+        {
+            return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+        }
+        void deallocate(T *ptr, size_t /*count*/)
+        {
+            ::operator delete(ptr, std::align_val_t(Alignment));
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment> & /*other*/) const { return true; }
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment> & /*other*/) const { return false; }
+    };
+
+    // Instruction sets the batch kernels can use. The best one the CPU supports is
+    // picked on first use; setSimdLevel() can force a lower one.
+    enum class SimdLevel
+    {
+        Scalar,
+        SSE42,
+        AVX2
+    };
+
+    SimdLevel simdLevel();
+    SimdLevel setSimdLevel(SimdLevel level);
+
+    // gcd of count pairs of magnitudes. With AVX2 eight lanes run binary GCD in lockstep and
+    // lanes that have finished are masked out; below AVX2 (SSE has no per-lane variable
+    // shift) every pair goes through the scalar Stein kernel.
+    void gcdBatch(const uint32_t *lhs, const uint32_t *rhs, uint32_t *out, size_t count);
+
+    // Normalize count fractions held as separate numerator and denominator columns in
+    // place, exactly as the Fraction constructor would: reduced, with a positive
+    // denominator. Zero denominators throw std::invalid_argument and unrepresentable
+    // results std::overflow_error, like the constructor. Use it on freshly parsed input and
+    // on FractionArray-style buffers after bulk arithmetic.
+    void reduceBatch(int *nums, int *dens, size_t count);
+
+    // Column of Fraction values stored as separate numerator and denominator arrays
+    // (structure of arrays), so the batch operators can run on vector registers.
+    // Element-wise results are identical to the scalar Fraction operators, including the
+    // overflow_error / runtime_error cases.
+    //
+    // The arithmetic operators form the cross products in 64-bit vector lanes and then
+    // reduce them. With AVX2, lanes whose products fit in int are reduced by the vector
+    // gcd of gcdBatch; wider lanes, and every lane below AVX2, reduce through the scalar
+    // 64-bit gcd, which then dominates the cost.
+    class FractionArray
+    {
+    public:
+        using Column = std::vector<int, AlignedAllocator<int, 32>>;
+        using Mask = std::vector<uint8_t>;
+
+    private:
+        Column numerator, denominator;
+
+    public:
+        FractionArray() = default;
+        explicit FractionArray(size_t count);
+        FractionArray(const std::vector<Fraction> &values);
+
+        size_t size() const { return numerator.size(); }
+        Fraction operator[](size_t index) const;
+        void set(size_t index, const Fraction &frac);
+        void push_back(const Fraction &frac);
+        std::vector<Fraction> toVector() const;
+
+        // Raw column access for bulk loading. Call reduce() after writing unreduced values:
+        // operator[] and toVector() read the columns as they are, without a gcd.
+        int *numerators() { return numerator.data(); }
+        int *denominators() { return denominator.data(); }
+        const int *numerators() const { return numerator.data(); }
+        const int *denominators() const { return denominator.data(); }
+
+        void reduce();
+
+        friend FractionArray operator+(const FractionArray &other, const FractionArray &frac);
+        friend FractionArray operator-(const FractionArray &other, const FractionArray &frac);
+        friend FractionArray operator*(const FractionArray &other, const FractionArray &frac);
+        friend FractionArray operator/(const FractionArray &other, const FractionArray &frac);
+
+        friend Mask operator==(const FractionArray &other, const FractionArray &frac);
+        friend Mask operator!=(const FractionArray &other, const FractionArray &frac);
+        friend Mask operator<(const FractionArray &other, const FractionArray &frac);
+        friend Mask operator>(const FractionArray &other, const FractionArray &frac);
+        friend Mask operator<=(const FractionArray &other, const FractionArray &frac);
+        friend Mask operator>=(const FractionArray &other, const FractionArray &frac);
+    };
+}
+
+#endif // FRACTIONARRAY_HPP
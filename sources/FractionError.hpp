@@ -0,0 +1,90 @@
+#ifndef FRACTIONERROR_HPP
+#define FRACTIONERROR_HPP
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+// Every throw in the library goes through FRACTION_THROW. Built with -fno-exceptions
+// (make demo_noexcept) it prints the message and aborts instead, so the library still
+// compiles and callers handle errors through the checked API below.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define FRACTION_THROW(type, message) throw type(message)
+#else
+#define FRACTION_THROW(type, message) ::ariel::failFast(message)
+#endif
+
+namespace ariel
+{
+    [[noreturn]] inline void failFast(const std::string &message)
+    {
+        std::fputs(message.c_str(), stderr);
+        std::fputc('\n', stderr);
+        std::abort();
+    }
+
+    // What went wrong in a checked operation. Each value maps to the exception the
+    // throwing API raises for the same input.
+    enum class FractionError
+    {
+        None,
+        ZeroDenominator, // std::invalid_argument
+        DivideByZero,    // std::runtime_error
+        Overflow,        // std::overflow_error
+        NotFinite        // std::invalid_argument
+    };
+
+    // Raise the exception the throwing API uses for error; what names the operation
+    [[noreturn]] inline void raise(FractionError error, const char *what)
+    {
+        switch (error)
+        {
+        case FractionError::ZeroDenominator:
+            FRACTION_THROW(std::invalid_argument, "Denominator cannot be zero");
+        case FractionError::DivideByZero:
+            FRACTION_THROW(std::runtime_error, "Denominator cannot be zero");
+        case FractionError::NotFinite:
+            FRACTION_THROW(std::invalid_argument, std::string("Non-finite value in ") + what);
+        case FractionError::Overflow:
+        case FractionError::None:
+        default:
+            FRACTION_THROW(std::overflow_error, std::string("Overflow in ") + what);
+        }
+    }
+
+    // Value-or-error result of the checked arithmetic, shaped like std::expected (which
+    // needs C++23) so callers can test it in a cold branch instead of unwinding
+    template <typename T>
+    class Checked
+    {
+    private:
+        T result;
+        FractionError status;
+
+    public:
+        constexpr Checked(const T &value) : result(value), status(FractionError::None) {}
+        constexpr Checked(FractionError error) : result(), status(error) {}
+
+        constexpr bool has_value() const { return status == FractionError::None; }
+        constexpr explicit operator bool() const { return has_value(); }
+        constexpr FractionError error() const { return status; }
+
+        // Unchecked access, like std::expected
+        constexpr const T &operator*() const { return result; }
+        constexpr const T *operator->() const { return &result; }
+
+        // Checked access: throws what the throwing operator would have thrown
+        constexpr const T &value() const
+        {
+            if (!has_value())
+            {
+                raise(status, "checked arithmetic");
+            }
+            return result;
+        }
+        constexpr T value_or(const T &fallback) const { return has_value() ? result : fallback; }
+    };
+}
+
+#endif // FRACTIONERROR_HPP
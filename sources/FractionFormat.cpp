@@ -0,0 +1,342 @@
+#include "FractionFormat.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+using namespace std;
+
+namespace ariel
+{
+
+    namespace
+    {
+        // "00" "01" ... "99", so every division by 100 produces two digits
+        constexpr char DIGIT_PAIRS[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        // Digits of value written backwards, ending right before end; returns the first one
+        char *writeDigits64(char *end, uint64_t value)
+        {
+            while (value >= 100)
+            {
+                auto pair = static_cast<size_t>(value % 100) * 2;
+                value /= 100;
+                *--end = DIGIT_PAIRS[pair + 1];
+                *--end = DIGIT_PAIRS[pair];
+            }
+            if (value >= 10)
+            {
+                auto pair = static_cast<size_t>(value) * 2;
+                *--end = DIGIT_PAIRS[pair + 1];
+                *--end = DIGIT_PAIRS[pair];
+            }
+            else
+            {
+                *--end = static_cast<char>('0' + value);
+            }
+            return end;
+        }
+
+        template <typename Unsigned>
+        char *writeDigits(char *end, Unsigned value)
+        {
+            if constexpr (sizeof(Unsigned) > sizeof(uint64_t))
+            {
+                // Peel 19-digit blocks with one wide division each, then finish in 64 bits
+                constexpr uint64_t BLOCK = 10000000000000000000ULL;
+                while (value > std::numeric_limits<uint64_t>::max())
+                {
+                    auto block = static_cast<uint64_t>(value % BLOCK);
+                    value /= BLOCK;
+                    char *start = writeDigits64(end, block);
+                    while (end - start < 19)
+                    {
+                        *--start = '0';
+                    }
+                    end = start;
+                }
+            }
+            return writeDigits64(end, static_cast<uint64_t>(value));
+        }
+
+        // Formats into scratch, which has MAX_FRACTION_CHARS<Int> bytes; returns the start
+        template <typename Int>
+        char *formatBackwards(char *scratch_end, const BasicFraction<Int> &frac)
+        {
+            char *pos = writeDigits(scratch_end, static_cast<typename FractionTraits<Int>::unsigned_type>(frac.getDenominator()));
+            *--pos = '/';
+            pos = writeDigits(pos, magnitude(frac.getNumerator()));
+            if (frac.getNumerator() < 0)
+            {
+                *--pos = '-';
+            }
+            return pos;
+        }
+
+        bool isDigit(char chr) { return chr >= '0' && chr <= '9'; }
+
+        // Number of leading decimal digits in the eight bytes at pos (which must be
+        // readable), with their value stored in value
+        template <typename Unsigned>
+        int parseEightDigits(const char *pos, Unsigned &value)
+        {
+            uint64_t chunk = 0;
+            memcpy(&chunk, pos, sizeof(chunk));
+            if constexpr (std::endian::native != std::endian::little)
+            {
+                chunk = __builtin_bswap64(chunk);
+            }
+            // A byte is a digit when both byte - '0' and byte - '0' + 0x76 stay below 0x80.
+            // Borrows and carries only run towards later bytes, past the first non-digit.
+            uint64_t shifted = chunk - 0x3030303030303030ULL;
+            uint64_t non_digits = (shifted | (shifted + 0x7676767676767676ULL)) & 0x8080808080808080ULL;
+            int count = non_digits == 0 ? 8 : trailingZeros(non_digits) / 8;
+            if (count == 0)
+            {
+                return 0;
+            }
+            // Drop the bytes after the run; the digits land in the top bytes as if padded
+            // with leading zeros. Then pairs, quads and the two halves are combined.
+            uint64_t digits = shifted << (8 * (8 - count));
+            digits = digits * 10 + (digits >> 8);
+            digits = (((digits & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+                      (((digits >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+                     32;
+            value = static_cast<Unsigned>(digits);
+            return count;
+        }
+
+        // A run of decimal digits. overflow is set (and the digits still consumed) once the
+        // magnitude exceeds the limit it was parsed against.
+        template <typename Unsigned>
+        struct ParsedInteger
+        {
+            const char *end;
+            Unsigned magnitude;
+            bool negative;
+            bool overflow;
+            int digits;
+        };
+
+        template <typename Unsigned>
+        ParsedInteger<Unsigned> parseDigits(const char *pos, const char *last, Unsigned limit, Unsigned start = 0)
+        {
+            ParsedInteger<Unsigned> parsed{pos, start, false, false, 0};
+            if (start == 0 && last - pos >= 8)
+            {
+                // Up to eight leading digits at once: the run length comes from a SWAR test
+                // and the conversion from three multiplies, with no branch per digit
+                pos += parseEightDigits(pos, parsed.magnitude);
+                if (pos != parsed.end + 8)
+                {
+                    parsed.digits = static_cast<int>(pos - parsed.end);
+                    parsed.end = pos;
+                    return parsed;
+                }
+            }
+            // Fewer than digits10 digits cannot reach the limit from zero, so only the
+            // tail of a long run pays for the overflow check
+            const char *safe_end = start != 0 ? pos : parsed.end + std::min<ptrdiff_t>(last - parsed.end, std::numeric_limits<Unsigned>::digits10);
+            for (; pos < safe_end && isDigit(*pos); ++pos)
+            {
+                parsed.magnitude = static_cast<Unsigned>(parsed.magnitude * 10 + static_cast<Unsigned>(*pos - '0'));
+            }
+            const Unsigned cutoff = limit / 10;
+            const auto cutoff_digit = static_cast<Unsigned>(limit % 10);
+            for (; pos != last && isDigit(*pos); ++pos)
+            {
+                auto digit = static_cast<Unsigned>(*pos - '0');
+                if (parsed.magnitude > cutoff || (parsed.magnitude == cutoff && digit > cutoff_digit))
+                {
+                    parsed.overflow = true;
+                }
+                parsed.magnitude = static_cast<Unsigned>(parsed.magnitude * 10 + digit);
+            }
+            parsed.digits = static_cast<int>(pos - parsed.end);
+            parsed.end = pos;
+            return parsed;
+        }
+
+        template <typename Unsigned>
+        ParsedInteger<Unsigned> parseSigned(const char *pos, const char *last, Unsigned max)
+        {
+            bool negative = false;
+            if (pos != last && (*pos == '-' || *pos == '+'))
+            {
+                negative = *pos == '-';
+                ++pos;
+            }
+            // The most negative value has one more unit of magnitude
+            ParsedInteger<Unsigned> parsed = parseDigits(pos, last, static_cast<Unsigned>(max + Unsigned(negative ? 1 : 0)));
+            parsed.negative = negative;
+            return parsed;
+        }
+    }
+
+    template <typename Int>
+    std::to_chars_result toChars(char *first, char *last, const BasicFraction<Int> &frac)
+    {
+        char scratch[MAX_FRACTION_CHARS<Int>];
+        char *end = scratch + sizeof(scratch);
+        char *start = formatBackwards(end, frac);
+        auto length = static_cast<size_t>(end - start);
+        if (static_cast<size_t>(last - first) < length)
+        {
+            return {last, std::errc::value_too_large};
+        }
+        std::memcpy(first, start, length);
+        return {first + length, std::errc()};
+    }
+
+    template <typename Int>
+    std::to_chars_result toChars(char *first, char *last, const BasicFraction<Int> *begin, const BasicFraction<Int> *end, char separator)
+    {
+        for (; begin != end; ++begin)
+        {
+            std::to_chars_result result = toChars(first, last, *begin);
+            if (result.ec != std::errc() || result.ptr == last)
+            {
+                return {last, std::errc::value_too_large};
+            }
+            *result.ptr = separator;
+            first = result.ptr + 1;
+        }
+        return {first, std::errc()};
+    }
+
+    template <typename Int>
+    std::ostream &writeFractions(std::ostream &ost, const BasicFraction<Int> *begin, const BasicFraction<Int> *end, char separator)
+    {
+        char buffer[1 << 16];
+        char *pos = buffer;
+        char *limit = buffer + sizeof(buffer) - MAX_FRACTION_CHARS<Int> - 1;
+        for (; begin != end; ++begin)
+        {
+            pos = toChars(pos, limit + MAX_FRACTION_CHARS<Int>, *begin).ptr;
+            *pos++ = separator;
+            if (pos >= limit)
+            {
+                ost.write(buffer, pos - buffer);
+                pos = buffer;
+            }
+        }
+        ost.write(buffer, pos - buffer);
+        return ost;
+    }
+
+    template <typename Int>
+    std::from_chars_result fromChars(const char *first, const char *last, BasicFraction<Int> &frac)
+    {
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+        const auto max = static_cast<Unsigned>(FractionTraits<Int>::max());
+        const std::from_chars_result no_match{first, std::errc::invalid_argument};
+
+        ParsedInteger<Unsigned> num = parseSigned(first, last, max);
+        const char *pos = num.end;
+        bool decimal = pos != last && *pos == '.' && pos + 1 != last && isDigit(pos[1]);
+        if (num.digits == 0 && !decimal)
+        {
+            return no_match;
+        }
+
+        Int numerator = 0;
+        Int denominator = 1;
+        bool overflow = num.overflow;
+        if (decimal)
+        {
+            // Trailing zeros of the fraction digits change nothing, so they do not count
+            // towards the power of ten and "1.2500000000" still fits an int
+            const char *digits = pos + 1;
+            const char *digits_end = digits;
+            while (digits_end != last && isDigit(*digits_end))
+            {
+                ++digits_end;
+            }
+            const char *significant = digits_end;
+            while (significant != digits && significant[-1] == '0')
+            {
+                --significant;
+            }
+            ParsedInteger<Unsigned> whole = parseDigits(digits, significant, static_cast<Unsigned>(max + Unsigned(num.negative ? 1 : 0)), num.magnitude);
+            Unsigned power = 1;
+            for (int i = 0; i < whole.digits && !overflow; ++i)
+            {
+                overflow = __builtin_mul_overflow(power, Unsigned(10), &power) || power > max;
+            }
+            pos = digits_end;
+            overflow = overflow || whole.overflow;
+            if (overflow)
+            {
+                return {pos, std::errc::result_out_of_range};
+            }
+            numerator = num.negative ? static_cast<Int>(Unsigned(0) - whole.magnitude) : static_cast<Int>(whole.magnitude);
+            denominator = static_cast<Int>(power);
+        }
+        else
+        {
+            const char *den_start = pos;
+            if (pos != last && *pos == '/')
+            {
+                ++den_start;
+            }
+            else
+            {
+                while (den_start != last && (*den_start == ' ' || *den_start == '\t'))
+                {
+                    ++den_start;
+                }
+                // "a b" needs the blank, otherwise there is no denominator at all
+                den_start = den_start == pos ? nullptr : den_start;
+            }
+            ParsedInteger<Unsigned> den{pos, 1, false, false, 0};
+            if (den_start != nullptr)
+            {
+                den = parseSigned(den_start, last, max);
+                if (den.digits == 0)
+                {
+                    if (*pos == '/')
+                    {
+                        return no_match;
+                    }
+                    // A lone integer followed by blanks: the blanks are not part of it
+                    den = ParsedInteger<Unsigned>{pos, 1, false, false, 0};
+                }
+            }
+            pos = den.end;
+            if (num.overflow || den.overflow)
+            {
+                return {pos, std::errc::result_out_of_range};
+            }
+            if (den.magnitude == 0)
+            {
+                return no_match;
+            }
+            numerator = num.negative ? static_cast<Int>(Unsigned(0) - num.magnitude) : static_cast<Int>(num.magnitude);
+            denominator = den.negative ? static_cast<Int>(Unsigned(0) - den.magnitude) : static_cast<Int>(den.magnitude);
+        }
+
+        Checked<BasicFraction<Int>> result = BasicFraction<Int>::make(numerator, denominator);
+        if (!result)
+        {
+            return {pos, std::errc::result_out_of_range};
+        }
+        frac = *result;
+        return {pos, std::errc()};
+    }
+
+    template std::to_chars_result toChars(char *first, char *last, const BasicFraction<int> &frac);
+    template std::to_chars_result toChars(char *first, char *last, const BasicFraction<int64_t> &frac);
+    template std::to_chars_result toChars(char *first, char *last, const BasicFraction<__int128> &frac);
+    template std::to_chars_result toChars(char *first, char *last, const BasicFraction<int> *begin, const BasicFraction<int> *end, char separator);
+    template std::to_chars_result toChars(char *first, char *last, const BasicFraction<int64_t> *begin, const BasicFraction<int64_t> *end, char separator);
+    template std::to_chars_result toChars(char *first, char *last, const BasicFraction<__int128> *begin, const BasicFraction<__int128> *end, char separator);
+    template std::ostream &writeFractions(std::ostream &ost, const BasicFraction<int> *begin, const BasicFraction<int> *end, char separator);
+    template std::ostream &writeFractions(std::ostream &ost, const BasicFraction<int64_t> *begin, const BasicFraction<int64_t> *end, char separator);
+    template std::ostream &writeFractions(std::ostream &ost, const BasicFraction<__int128> *begin, const BasicFraction<__int128> *end, char separator);
+    template std::from_chars_result fromChars(const char *first, const char *last, BasicFraction<int> &frac);
+    template std::from_chars_result fromChars(const char *first, const char *last, BasicFraction<int64_t> &frac);
+    template std::from_chars_result fromChars(const char *first, const char *last, BasicFraction<__int128> &frac);
+
+}
@@ -0,0 +1,56 @@
+#ifndef FRACTIONFORMAT_HPP
+#define FRACTIONFORMAT_HPP
+
+#include "Fraction.hpp"
+#include <charconv>
+#include <cstddef>
+#include <iostream>
+
+namespace ariel
+{
+    // Longest "num/den" any BasicFraction<Int> formats to: a sign, the digits of the most
+    // negative numerator, the slash and the digits of the largest denominator
+    template <typename Int>
+    constexpr size_t MAX_FRACTION_CHARS = 1 + 2 * (std::numeric_limits<typename FractionTraits<Int>::unsigned_type>::digits10 + 1) + 1;
+
+    // Writes "num/den" into [first, last) like std::to_chars: no locale, no allocation, no
+    // stream. On success ptr is one past the last character; when the buffer is too
+    // small ec is std::errc::value_too_large, ptr is last and the buffer contents are
+    // unspecified.
+    template <typename Int>
+    std::to_chars_result toChars(char *first, char *last, const BasicFraction<Int> &frac);
+
+    // Bulk form: every fraction of [begin, end) followed by separator
+    template <typename Int>
+    std::to_chars_result toChars(char *first, char *last, const BasicFraction<Int> *begin, const BasicFraction<Int> *end, char separator = '\n');
+
+    // Streams [begin, end) through a fixed buffer, one ost.write() per full buffer
+    template <typename Int>
+    std::ostream &writeFractions(std::ostream &ost, const BasicFraction<Int> *begin, const BasicFraction<Int> *end, char separator = '\n');
+
+    // Parses a fraction from the start of [first, last) like std::from_chars: no locale,
+    // no allocation, no exceptions, no leading whitespace. Accepted forms are "a/b",
+    // "a b" (spaces or tabs in between), a plain integer "a" and a decimal "1.25" or
+    // ".5"; a and b may carry a sign. On success frac holds the reduced value and ptr
+    // points past the match. No match gives std::errc::invalid_argument with ptr ==
+    // first, as does a zero denominator; values that do not fit give
+    // std::errc::result_out_of_range with ptr past the match. frac is only written on
+    // success.
+    template <typename Int>
+    std::from_chars_result fromChars(const char *first, const char *last, BasicFraction<Int> &frac);
+
+    extern template std::to_chars_result toChars(char *first, char *last, const BasicFraction<int> &frac);
+    extern template std::to_chars_result toChars(char *first, char *last, const BasicFraction<int64_t> &frac);
+    extern template std::to_chars_result toChars(char *first, char *last, const BasicFraction<__int128> &frac);
+    extern template std::to_chars_result toChars(char *first, char *last, const BasicFraction<int> *begin, const BasicFraction<int> *end, char separator);
+    extern template std::to_chars_result toChars(char *first, char *last, const BasicFraction<int64_t> *begin, const BasicFraction<int64_t> *end, char separator);
+    extern template std::to_chars_result toChars(char *first, char *last, const BasicFraction<__int128> *begin, const BasicFraction<__int128> *end, char separator);
+    extern template std::ostream &writeFractions(std::ostream &ost, const BasicFraction<int> *begin, const BasicFraction<int> *end, char separator);
+    extern template std::ostream &writeFractions(std::ostream &ost, const BasicFraction<int64_t> *begin, const BasicFraction<int64_t> *end, char separator);
+    extern template std::ostream &writeFractions(std::ostream &ost, const BasicFraction<__int128> *begin, const BasicFraction<__int128> *end, char separator);
+    extern template std::from_chars_result fromChars(const char *first, const char *last, BasicFraction<int> &frac);
+    extern template std::from_chars_result fromChars(const char *first, const char *last, BasicFraction<int64_t> &frac);
+    extern template std::from_chars_result fromChars(const char *first, const char *last, BasicFraction<__int128> &frac);
+}
+
+#endif // FRACTIONFORMAT_HPP
@@ -0,0 +1,242 @@
+#ifndef FRACTIONHASHMAP_HPP
+#define FRACTIONHASHMAP_HPP
+
+#include "Fraction.hpp"
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace ariel
+{
+    // Open-addressing hash map from fractions to Value, for dedup and group-by over many
+    // keys. Entries sit inline in one array of slots (for Fraction keys and small values,
+    // 8 bytes of key next to the value), probed linearly from hashValue(key): a lookup is
+    // one hash and usually one cache line, and an insert never allocates a node. A zero
+    // denominator marks an empty slot, so there is no separate metadata array. Erase
+    // shifts the following entries back instead of leaving tombstones, so probe lengths
+    // do not grow with churn.
+    //
+    // The table doubles at MAX_LOAD_PERCENT occupancy. Value must be default
+    // constructible; empty slots hold a default Value. Inserting, erasing and reserve()
+    // invalidate iterators and pointers to values.
+    template <typename Int, typename Value>
+    class BasicFractionHashMap
+    {
+    public:
+        static constexpr size_t MAX_LOAD_PERCENT = 75;
+
+        class Entry
+        {
+        private:
+            friend class BasicFractionHashMap;
+            BasicFraction<Int> fraction;
+
+        public:
+            Value value{};
+
+            const BasicFraction<Int> &key() const { return fraction; }
+        };
+
+        template <typename Slot>
+        class Iterator
+        {
+        private:
+            Slot *pos;
+            Slot *last;
+
+            void skipEmpty()
+            {
+                while (pos != last && isEmpty(*pos))
+                {
+                    ++pos;
+                }
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entry;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Slot *;
+            using reference = Slot &;
+
+            Iterator(Slot *pos = nullptr, Slot *last = nullptr) : pos(pos), last(last) { skipEmpty(); }
+
+            Slot &operator*() const { return *pos; }
+            Slot *operator->() const { return pos; }
+            Iterator &operator++()
+            {
+                ++pos;
+                skipEmpty();
+                return *this;
+            }
+            Iterator operator++(int)
+            {
+                Iterator result = *this;
+                ++*this;
+                return result;
+            }
+            friend bool operator==(const Iterator &lhs, const Iterator &rhs) { return lhs.pos == rhs.pos; }
+            friend bool operator!=(const Iterator &lhs, const Iterator &rhs) { return lhs.pos != rhs.pos; }
+        };
+
+        using iterator = Iterator<Entry>;
+        using const_iterator = Iterator<const Entry>;
+
+        BasicFractionHashMap() = default;
+        // Sized so that count keys fit without growing
+        explicit BasicFractionHashMap(size_t count) { reserve(count); }
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        size_t capacity() const { return slots.size(); }
+
+        void reserve(size_t keys)
+        {
+            size_t wanted = MIN_CAPACITY;
+            while (wanted * MAX_LOAD_PERCENT / 100 < keys)
+            {
+                wanted *= 2;
+            }
+            if (wanted > slots.size())
+            {
+                rehash(wanted);
+            }
+        }
+
+        void clear()
+        {
+            for (Entry &slot : slots)
+            {
+                slot = emptySlot();
+            }
+            count = 0;
+        }
+
+        Value *find(const BasicFraction<Int> &key) { return const_cast<Value *>(std::as_const(*this).find(key)); }
+        const Value *find(const BasicFraction<Int> &key) const
+        {
+            if (slots.empty())
+            {
+                return nullptr;
+            }
+            for (size_t index = home(key);; index = (index + 1) & mask())
+            {
+                const Entry &slot = slots[index];
+                if (slot.fraction == key)
+                {
+                    return &slot.value;
+                }
+                if (isEmpty(slot))
+                {
+                    return nullptr;
+                }
+            }
+        }
+        bool contains(const BasicFraction<Int> &key) const { return find(key) != nullptr; }
+
+        // Inserts key with value unless it is already present; returns its value and
+        // whether it was inserted, like std::unordered_map::try_emplace
+        std::pair<Value *, bool> insert(const BasicFraction<Int> &key, Value value = Value())
+        {
+            if ((count + 1) * 100 > slots.size() * MAX_LOAD_PERCENT)
+            {
+                rehash(slots.empty() ? MIN_CAPACITY : 2 * slots.size());
+            }
+            size_t index = home(key);
+            for (; !isEmpty(slots[index]); index = (index + 1) & mask())
+            {
+                if (slots[index].fraction == key)
+                {
+                    return {&slots[index].value, false};
+                }
+            }
+            slots[index].fraction = key;
+            slots[index].value = std::move(value);
+            ++count;
+            return {&slots[index].value, true};
+        }
+
+        Value &operator[](const BasicFraction<Int> &key) { return *insert(key).first; }
+
+        // Removes key; false when it was not present
+        bool erase(const BasicFraction<Int> &key)
+        {
+            if (slots.empty())
+            {
+                return false;
+            }
+            size_t hole = home(key);
+            for (; !(slots[hole].fraction == key); hole = (hole + 1) & mask())
+            {
+                if (isEmpty(slots[hole]))
+                {
+                    return false;
+                }
+            }
+            // Backward shift: an entry further along the run moves into the hole when the
+            // hole lies between its home slot and where it sits now
+            for (size_t next = (hole + 1) & mask(); !isEmpty(slots[next]); next = (next + 1) & mask())
+            {
+                if (((next - home(slots[next].fraction)) & mask()) >= ((next - hole) & mask()))
+                {
+                    slots[hole] = std::move(slots[next]);
+                    hole = next;
+                }
+            }
+            slots[hole] = emptySlot();
+            --count;
+            return true;
+        }
+
+        iterator begin() { return iterator(slots.data(), slots.data() + slots.size()); }
+        iterator end() { return iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+        const_iterator begin() const { return const_iterator(slots.data(), slots.data() + slots.size()); }
+        const_iterator end() const { return const_iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+
+    private:
+        static constexpr size_t MIN_CAPACITY = 16;
+
+        std::vector<Entry> slots;
+        size_t count = 0;
+
+        static Entry emptySlot()
+        {
+            Entry slot;
+            slot.fraction = BasicFraction<Int>::fromReduced(ReducedKey(), 0, 0);
+            return slot;
+        }
+        static bool isEmpty(const Entry &slot) { return slot.fraction.getDenominator() == 0; }
+
+        // Capacities are powers of two, so the slot index is the low bits of the hash
+        size_t mask() const { return slots.size() - 1; }
+        size_t home(const BasicFraction<Int> &key) const { return hashValue(key) & mask(); }
+
+        void rehash(size_t capacity)
+        {
+            std::vector<Entry> old(capacity, emptySlot());
+            old.swap(slots);
+            for (Entry &slot : old)
+            {
+                if (!isEmpty(slot))
+                {
+                    size_t index = home(slot.fraction);
+                    while (!isEmpty(slots[index]))
+                    {
+                        index = (index + 1) & mask();
+                    }
+                    slots[index] = std::move(slot);
+                }
+            }
+        }
+    };
+
+    template <typename Value>
+    using FractionHashMap = BasicFractionHashMap<int, Value>;
+    template <typename Value>
+    using Fraction64HashMap = BasicFractionHashMap<int64_t, Value>;
+    template <typename Value>
+    using Fraction128HashMap = BasicFractionHashMap<__int128, Value>;
+}
+
+#endif // FRACTIONHASHMAP_HPP
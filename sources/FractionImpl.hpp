@@ -0,0 +1,259 @@
+#ifndef FRACTIONIMPL_HPP
+#define FRACTIONIMPL_HPP
+
+// Out-of-line BasicFraction definitions: the float overloads and the stream operators.
+// Fraction.cpp compiles them once with explicit instantiations; with
+// FRACTION_HEADER_ONLY, Fraction.hpp includes this file instead, so callers can inline them.
+
+#include "Fraction.hpp"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <numeric>
+#include <iomanip>
+#include <string>
+#include <type_traits>
+#include <cctype>
+
+namespace ariel
+{
+
+    // Helpers of the out-of-line definitions. Named and inline rather than in an anonymous
+    // namespace, since in header-only mode every translation unit sees them.
+    namespace detail
+    {
+        // Round a float to 3 decimal places
+        inline float roundFloat(float num)
+        {
+            float rounded_num = round(num * 1000.0f) / 1000.0f;
+            return rounded_num;
+        }
+
+        // Stream helpers: iostreams have no overloads for __int128, so that backend is
+        // printed and parsed digit by digit. The native backends go straight to the stream.
+        template <typename Int>
+        void writeInteger(std::ostream &ost, Int value)
+        {
+            if constexpr (std::is_same_v<Int, __int128>)
+            {
+                char digits[48];
+                char *end = digits + sizeof(digits);
+                char *pos = end;
+                auto mag = magnitude(value);
+                do
+                {
+                    *--pos = static_cast<char>('0' + static_cast<int>(mag % 10));
+                    mag /= 10;
+                } while (mag != 0);
+                if (value < 0)
+                {
+                    *--pos = '-';
+                }
+                ost << std::string(pos, end);
+            }
+            else
+            {
+                ost << value;
+            }
+        }
+
+        template <typename Int>
+        void readInteger(std::istream &ist, Int &value)
+        {
+            if constexpr (std::is_same_v<Int, __int128>)
+            {
+                using Unsigned = typename FractionTraits<Int>::unsigned_type;
+                std::istream::sentry sentry(ist);
+                if (!sentry)
+                {
+                    return;
+                }
+                bool negative = false;
+                if (ist.peek() == '-' || ist.peek() == '+')
+                {
+                    negative = ist.get() == '-';
+                }
+                Unsigned limit = static_cast<Unsigned>(FractionTraits<Int>::max()) + Unsigned(negative ? 1 : 0);
+                Unsigned mag = 0;
+                bool any = false;
+                while (std::isdigit(ist.peek()) != 0)
+                {
+                    auto digit = static_cast<Unsigned>(ist.get() - '0');
+                    if (mag > (limit - digit) / 10)
+                    {
+                        ist.setstate(std::ios::failbit);
+                        return;
+                    }
+                    mag = mag * 10 + digit;
+                    any = true;
+                }
+                if (!any)
+                {
+                    ist.setstate(std::ios::failbit);
+                    return;
+                }
+                value = negative ? static_cast<Int>(Unsigned(0) - mag) : static_cast<Int>(mag);
+            }
+            else
+            {
+                ist >> value;
+            }
+        }
+    }
+
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::fromDecimal(double flt)
+    {
+        double rounded_flt = round(flt * 1000) / 1000;
+        return BasicFraction(static_cast<Int>(rounded_flt * FRACTION_SCALE), FRACTION_SCALE);
+    }
+
+    // Overloaded operator+ with Fraction and float operand
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::add(const BasicFraction &other, float frac)
+    {
+        frac = detail::roundFloat(frac);
+        Int scaled_num = static_cast<Int>(frac * FRACTION_SCALE);
+        Int new_num = other.numerator * FRACTION_SCALE + other.denominator * scaled_num;
+        Int new_den = other.denominator * FRACTION_SCALE;
+
+        float result = static_cast<float>(new_num) / static_cast<float>(new_den);
+        Int rounded_num = static_cast<Int>(result * static_cast<float>(new_den));
+        return BasicFraction(rounded_num, new_den);
+    }
+
+    // Overloaded operator- with Fraction and float operand
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::subtract(const BasicFraction &other, float frac)
+    {
+        Int scaled_num = static_cast<Int>(frac * FRACTION_SCALE);
+        Int new_num = other.numerator * FRACTION_SCALE - other.denominator * scaled_num;
+        Int new_den = other.denominator * FRACTION_SCALE;
+
+        BasicFraction result_fraction(new_num, new_den);
+
+        float result = static_cast<float>(result_fraction.getNumerator()) / static_cast<float>(result_fraction.getDenominator());
+        result = detail::roundFloat(result);
+
+        return BasicFraction(static_cast<Int>(result * static_cast<float>(result_fraction.getDenominator())), result_fraction.getDenominator());
+    }
+
+    // Overloaded operator* with Fraction and float operand
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::multiply(const BasicFraction &other, float frac)
+    {
+        frac = detail::roundFloat(frac);
+        return BasicFraction(other.numerator * static_cast<Int>(frac * FRACTION_SCALE), other.denominator * FRACTION_SCALE);
+    }
+
+    // Overloaded operator/ with Fraction and float operand
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::divide(const BasicFraction &other, float frac)
+    {
+        if (frac == 0)
+        {
+            FRACTION_THROW(std::runtime_error, "Denominator cannot be zero");
+        }
+        frac = detail::roundFloat(frac);
+        return BasicFraction(FRACTION_SCALE * other.numerator, static_cast<Int>(frac * FRACTION_SCALE) * other.denominator);
+    }
+
+    // Overloaded operator+ with float and Fraction operand
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::add(float frac, const BasicFraction &other)
+    {
+        frac = detail::roundFloat(frac);
+        Int scaled_num = static_cast<Int>(frac * FRACTION_SCALE);
+        Int new_num = other.numerator * FRACTION_SCALE + other.denominator * scaled_num;
+        Int new_den = other.denominator * FRACTION_SCALE;
+        float result = static_cast<float>(new_num) / static_cast<float>(new_den);
+        Int rounded_num = static_cast<Int>(result * static_cast<float>(new_den));
+        return BasicFraction(rounded_num, new_den);
+    }
+
+    // Overloaded operator- with float and Fraction operand
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::subtract(float frac, const BasicFraction &other)
+    {
+        frac = detail::roundFloat(frac);
+        Int scaled_num = static_cast<Int>(frac * FRACTION_SCALE);
+        Int new_num = scaled_num * other.denominator - other.numerator * FRACTION_SCALE;
+        Int new_den = other.denominator * FRACTION_SCALE;
+        float result = static_cast<float>(new_num) / static_cast<float>(new_den);
+        Int rounded_num = static_cast<Int>(result * static_cast<float>(new_den));
+        return BasicFraction(rounded_num, new_den);
+    }
+
+    // Overloaded operator* with float and Fraction operand
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::multiply(float frac, const BasicFraction &other)
+    {
+        return BasicFraction(other.numerator * static_cast<Int>(frac * FRACTION_SCALE), other.denominator * FRACTION_SCALE);
+    }
+
+    // Overloaded operator/ with float and Fraction operand
+    template <typename Int>
+    BasicFraction<Int> BasicFraction<Int>::divide(float frac, const BasicFraction &other)
+    {
+        if (other.numerator == 0)
+        {
+            FRACTION_THROW(std::invalid_argument, "Denominator cannot be zero");
+        }
+        float result = static_cast<float>(static_cast<Int>(frac * static_cast<float>(other.denominator) * FRACTION_SCALE));
+        result = detail::roundFloat(result);
+        return BasicFraction(static_cast<Int>(result), FRACTION_SCALE * other.numerator);
+    }
+
+    template <typename Int>
+    bool BasicFraction<Int>::equals(const BasicFraction &other, float frac)
+    {
+        float epsilon = 0.000001; // Define an epsilon value for tolerance
+        float fractionValue = static_cast<float>(other.numerator) / static_cast<float>(other.denominator);
+        return std::abs(fractionValue - frac) < epsilon;
+    }
+
+    template <typename Int>
+    std::ostream &operator<<(std::ostream &ost, const BasicFraction<Int> &frac)
+    {
+        detail::writeInteger(ost, frac.getNumerator());
+        ost << '/';
+        detail::writeInteger(ost, frac.getDenominator());
+        return ost;
+    }
+
+    template <typename Int>
+    std::istream &operator>>(std::istream &ist, BasicFraction<Int> &frac)
+    {
+        Int numerator = 0;
+        Int denominator = 0;
+        detail::readInteger(ist, numerator);
+        detail::readInteger(ist, denominator);
+
+        if (ist.fail())
+        {
+            FRACTION_THROW(std::runtime_error, "Invalid input format");
+        }
+
+        if (denominator == 0)
+        {
+            FRACTION_THROW(std::runtime_error, "Invalid fraction format");
+        }
+
+        if (numerator == 0)
+        {
+            frac.numerator = 0;
+            frac.denominator = 1;
+            return ist;
+        }
+
+        frac.numerator = numerator;
+        frac.denominator = denominator;
+
+        // reduce() also moves the sign onto the numerator
+        frac.reduce();
+        return ist;
+    }
+
+}
+
+#endif // FRACTIONIMPL_HPP
@@ -0,0 +1,355 @@
+#include "FractionLoader.hpp"
+#include "FractionFormat.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+using namespace std;
+
+namespace ariel
+{
+    namespace
+    {
+        // Below this much input per thread, starting the thread costs more than it saves
+        constexpr size_t MIN_CHUNK_BYTES = size_t(1) << 20;
+        constexpr char BINARY_MAGIC[4] = {'F', 'R', 'A', 'C'};
+        constexpr unsigned char BINARY_VERSION = 1;
+
+        // Read-only mapping of a whole file, unmapped on destruction
+        class MappedFile
+        {
+        private:
+            const char *bytes = nullptr;
+            size_t length = 0;
+
+        public:
+            explicit MappedFile(const string &path)
+            {
+                int file = ::open(path.c_str(), O_RDONLY);
+                if (file < 0)
+                {
+                    FRACTION_THROW(runtime_error, "Cannot open " + path);
+                }
+                struct stat info
+                {
+                };
+                if (::fstat(file, &info) != 0)
+                {
+                    ::close(file);
+                    FRACTION_THROW(runtime_error, "Cannot read " + path);
+                }
+                length = static_cast<size_t>(info.st_size);
+                if (length == 0)
+                {
+                    ::close(file);
+                    return;
+                }
+                // The mapping keeps its own reference to the file
+                void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+                ::close(file);
+                if (mapping == MAP_FAILED)
+                {
+                    FRACTION_THROW(runtime_error, "Cannot map " + path);
+                }
+                ::madvise(mapping, length, MADV_SEQUENTIAL);
+                bytes = static_cast<const char *>(mapping);
+            }
+            ~MappedFile()
+            {
+                if (bytes != nullptr)
+                {
+                    ::munmap(const_cast<char *>(bytes), length);
+                }
+            }
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            const char *data() const { return bytes; }
+            size_t size() const { return length; }
+        };
+
+        // Where the first bad entry of a chunk is: a byte offset (text) or record index
+        // (binary). npos when the chunk parsed cleanly.
+        struct ChunkError
+        {
+            size_t position = string::npos;
+            errc code = errc();
+        };
+
+        unsigned threadCount(unsigned requested, size_t bytes, size_t records)
+        {
+            if (requested == 0)
+            {
+                requested = max(1U, thread::hardware_concurrency());
+                requested = static_cast<unsigned>(min<size_t>(requested, max<size_t>(1, bytes / MIN_CHUNK_BYTES)));
+            }
+            return static_cast<unsigned>(max<size_t>(1, min<size_t>(requested, records)));
+        }
+
+        [[noreturn]] void raiseLoadError(errc code, const string &where)
+        {
+            if (code == errc::result_out_of_range)
+            {
+                FRACTION_THROW(overflow_error, "Overflow in " + where);
+            }
+            FRACTION_THROW(runtime_error, "Invalid fraction in " + where);
+        }
+
+        bool isSpace(char chr) { return chr == ' ' || chr == '\n' || chr == '\t' || chr == '\r' || chr == '\v' || chr == '\f'; }
+
+        template <typename Int>
+        ChunkError parseText(const char *base, const char *first, const char *last, vector<BasicFraction<Int>> &out)
+        {
+            out.reserve(static_cast<size_t>(last - first) / 8);
+            BasicFraction<Int> frac;
+            const char *pos = first;
+            while (true)
+            {
+                while (pos != last && isSpace(*pos))
+                {
+                    ++pos;
+                }
+                if (pos == last)
+                {
+                    return {};
+                }
+                from_chars_result result = fromChars(pos, last, frac);
+                // A record has to end at whitespace, so "1/2x" is an error rather than 1/2
+                if (result.ec == errc() && result.ptr != last && !isSpace(*result.ptr))
+                {
+                    result.ec = errc::invalid_argument;
+                }
+                if (result.ec != errc())
+                {
+                    return {static_cast<size_t>(pos - base), result.ec};
+                }
+                out.push_back(frac);
+                pos = result.ptr;
+            }
+        }
+
+        template <typename Int>
+        vector<BasicFraction<Int>> loadText(const MappedFile &file, const string &path, unsigned threads)
+        {
+            const char *data = file.data();
+            const size_t size = file.size();
+            unsigned count = threadCount(threads, size, size);
+
+            // Even split points, each moved past the next line break so no record is cut
+            vector<const char *> bounds(count + 1, data + size);
+            bounds[0] = data;
+            for (unsigned chunk = 1; chunk < count; ++chunk)
+            {
+                const char *split = max(data + size / count * chunk, bounds[chunk - 1]);
+                if (split != data && split[-1] != '\n')
+                {
+                    const void *newline = memchr(split, '\n', static_cast<size_t>(data + size - split));
+                    split = newline == nullptr ? data + size : static_cast<const char *>(newline) + 1;
+                }
+                bounds[chunk] = split;
+            }
+
+            vector<vector<BasicFraction<Int>>> parts(count);
+            vector<ChunkError> errors(count);
+            detail::runChunks(count, [&](unsigned chunk)
+                              { errors[chunk] = parseText(data, bounds[chunk], bounds[chunk + 1], parts[chunk]); });
+
+            for (const ChunkError &error : errors)
+            {
+                if (error.position != string::npos)
+                {
+                    auto line = static_cast<size_t>(count_if(data, data + error.position, [](char chr)
+                                                             { return chr == '\n'; }));
+                    raiseLoadError(error.code, "line " + to_string(line + 1) + " of " + path);
+                }
+            }
+
+            vector<size_t> offsets(count + 1, 0);
+            for (unsigned chunk = 0; chunk < count; ++chunk)
+            {
+                offsets[chunk + 1] = offsets[chunk] + parts[chunk].size();
+            }
+            vector<BasicFraction<Int>> result(offsets[count]);
+            detail::runChunks(count, [&](unsigned chunk)
+                              {
+                                  copy(parts[chunk].begin(), parts[chunk].end(), result.data() + offsets[chunk]);
+                                  vector<BasicFraction<Int>>().swap(parts[chunk]); });
+            return result;
+        }
+
+        // Fixed-width little-endian fields. memcpy keeps the loads unaligned-safe and
+        // compiles to a plain load on little-endian hosts.
+        template <typename T>
+        T loadLittle(const char *pos)
+        {
+            T value;
+            if constexpr (endian::native == endian::little)
+            {
+                memcpy(&value, pos, sizeof(T));
+            }
+            else
+            {
+                char bytes[sizeof(T)];
+                reverse_copy(pos, pos + sizeof(T), bytes);
+                memcpy(&value, bytes, sizeof(T));
+            }
+            return value;
+        }
+
+        template <typename T>
+        char *storeLittle(char *pos, T value)
+        {
+            memcpy(pos, &value, sizeof(T));
+            if constexpr (endian::native != endian::little)
+            {
+                reverse(pos, pos + sizeof(T));
+            }
+            return pos + sizeof(T);
+        }
+
+        // One integer field of width bytes; false when it does not fit in Int
+        template <typename Int>
+        bool readField(const char *pos, size_t width, Int &value)
+        {
+            if (width == sizeof(Int))
+            {
+                value = loadLittle<Int>(pos);
+                return true;
+            }
+            unsigned __int128 raw = 0;
+            for (size_t byte = width; byte-- > 0;)
+            {
+                raw = (raw << 8) | static_cast<unsigned char>(pos[byte]);
+            }
+            if (width < sizeof(raw) && (raw >> (8 * width - 1)) != 0)
+            {
+                raw |= ~static_cast<unsigned __int128>(0) << (8 * width);
+            }
+            auto wide = static_cast<__int128>(raw);
+            if (wide < FractionTraits<Int>::min() || wide > FractionTraits<Int>::max())
+            {
+                return false;
+            }
+            value = static_cast<Int>(wide);
+            return true;
+        }
+
+        template <typename Int>
+        vector<BasicFraction<Int>> loadBinary(const MappedFile &file, const string &path, unsigned threads)
+        {
+            const char *data = file.data();
+            const size_t size = file.size();
+            if (size < BINARY_HEADER_SIZE || memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 ||
+                static_cast<unsigned char>(data[4]) != BINARY_VERSION || data[6] != 0 || data[7] != 0)
+            {
+                FRACTION_THROW(runtime_error, "Not a binary fraction file: " + path);
+            }
+            const auto width = static_cast<size_t>(static_cast<unsigned char>(data[5]));
+            const auto records = loadLittle<uint64_t>(data + 8);
+            if ((width != 4 && width != 8 && width != 16) || (size - BINARY_HEADER_SIZE) / (2 * width) != records ||
+                (size - BINARY_HEADER_SIZE) % (2 * width) != 0)
+            {
+                FRACTION_THROW(runtime_error, "Truncated or corrupt binary fraction file: " + path);
+            }
+
+            // Records have a fixed width, so the chunks are plain index ranges and every
+            // thread decodes straight into the result
+            vector<BasicFraction<Int>> result(records);
+            unsigned count = threadCount(threads, size, records);
+            vector<ChunkError> errors(count);
+            detail::runChunks(count, [&](unsigned chunk)
+                              {
+                                  size_t end = records / count * (chunk + 1) + (chunk + 1 == count ? records % count : 0);
+                                  for (size_t index = records / count * chunk; index < end; ++index)
+                                  {
+                                      const char *record = data + BINARY_HEADER_SIZE + index * 2 * width;
+                                      Int num = 0;
+                                      Int den = 0;
+                                      if (!readField(record, width, num) || !readField(record + width, width, den))
+                                      {
+                                          errors[chunk] = {index, errc::result_out_of_range};
+                                          return;
+                                      }
+                                      Checked<BasicFraction<Int>> frac = BasicFraction<Int>::make(num, den);
+                                      if (!frac)
+                                      {
+                                          errors[chunk] = {index, frac.error() == FractionError::Overflow ? errc::result_out_of_range : errc::invalid_argument};
+                                          return;
+                                      }
+                                      result[index] = *frac;
+                                  } });
+        
+            for (const ChunkError &error : errors)
+            {
+                if (error.position != string::npos)
+                {
+                    raiseLoadError(error.code, "record " + to_string(error.position) + " of " + path);
+                }
+            }
+            return result;
+        }
+    }
+
+    template <typename Int>
+    vector<BasicFraction<Int>> loadFractions(const string &path, FractionFileFormat format, unsigned threads)
+    {
+        MappedFile file(path);
+        if (format == FractionFileFormat::Binary)
+        {
+            return loadBinary<Int>(file, path, threads);
+        }
+        return loadText<Int>(file, path, threads);
+    }
+
+    template <typename Int>
+    void saveFractions(const string &path, const BasicFraction<Int> *begin, const BasicFraction<Int> *end, FractionFileFormat format)
+    {
+        ofstream out(path, ios::binary | ios::trunc);
+        if (format == FractionFileFormat::Text)
+        {
+            writeFractions(out, begin, end);
+        }
+        else
+        {
+            char header[BINARY_HEADER_SIZE] = {};
+            memcpy(header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+            header[4] = static_cast<char>(BINARY_VERSION);
+            header[5] = static_cast<char>(sizeof(Int));
+            storeLittle(header + 8, static_cast<uint64_t>(end - begin));
+            out.write(header, sizeof(header));
+
+            // Records go out through a fixed buffer, like writeFractions
+            char buffer[1 << 16];
+            char *pos = buffer;
+            for (const BasicFraction<Int> *frac = begin; frac != end; ++frac)
+            {
+                if (pos + 2 * sizeof(Int) > buffer + sizeof(buffer))
+                {
+                    out.write(buffer, pos - buffer);
+                    pos = buffer;
+                }
+                pos = storeLittle(pos, frac->getNumerator());
+                pos = storeLittle(pos, frac->getDenominator());
+            }
+            out.write(buffer, pos - buffer);
+        }
+        out.close();
+        if (!out)
+        {
+            FRACTION_THROW(runtime_error, "Cannot write " + path);
+        }
+    }
+
+    template vector<BasicFraction<int>> loadFractions(const string &path, FractionFileFormat format, unsigned threads);
+    template vector<BasicFraction<int64_t>> loadFractions(const string &path, FractionFileFormat format, unsigned threads);
+    template vector<BasicFraction<__int128>> loadFractions(const string &path, FractionFileFormat format, unsigned threads);
+    template void saveFractions(const string &path, const BasicFraction<int> *begin, const BasicFraction<int> *end, FractionFileFormat format);
+    template void saveFractions(const string &path, const BasicFraction<int64_t> *begin, const BasicFraction<int64_t> *end, FractionFileFormat format);
+    template void saveFractions(const string &path, const BasicFraction<__int128> *begin, const BasicFraction<__int128> *end, FractionFileFormat format);
+}
@@ -0,0 +1,52 @@
+#ifndef FRACTIONLOADER_HPP
+#define FRACTIONLOADER_HPP
+
+#include "Fraction.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ariel
+{
+    // On-disk layouts for loadFractions / saveFractions.
+    //
+    //   Text    records accepted by fromChars ("a/b", "a b", "a", "1.25") separated by
+    //           whitespace; a record never spans a line break
+    //   Binary  a 16-byte header, then count fixed-width records. The header is the
+    //           magic "FRAC", a version byte (1), the width in bytes of one integer (4, 8
+    //           or 16), two zero bytes and the record count as a little-endian uint64.
+    //           Each record is the numerator and then the denominator, little-endian
+    //           two's complement, width bytes each.
+    enum class FractionFileFormat
+    {
+        Text,
+        Binary
+    };
+
+    constexpr size_t BINARY_HEADER_SIZE = 16;
+
+    // Memory-maps path and parses it on threads threads (0 picks one per core, with at
+    // least a megabyte per thread) into one contiguous buffer. Text is split at line
+    // breaks after even byte offsets, binary at record boundaries; each chunk parses on
+    // its own and the results are concatenated in file order. Every value is reduced like
+    // the constructor reduces it, so binary records need not be. Unreadable files and
+    // malformed records throw std::runtime_error, values that do not fit in Int
+    // std::overflow_error; the message names the line (text) or record (binary) of the
+    // first bad entry in the file.
+    template <typename Int>
+    std::vector<BasicFraction<Int>> loadFractions(const std::string &path, FractionFileFormat format = FractionFileFormat::Text, unsigned threads = 0);
+
+    // Writes [begin, end) to path in format, replacing the file; text is one fraction per
+    // line. Binary files record sizeof(Int) as the width.
+    template <typename Int>
+    void saveFractions(const std::string &path, const BasicFraction<Int> *begin, const BasicFraction<Int> *end, FractionFileFormat format = FractionFileFormat::Text);
+
+    extern template std::vector<BasicFraction<int>> loadFractions(const std::string &path, FractionFileFormat format, unsigned threads);
+    extern template std::vector<BasicFraction<int64_t>> loadFractions(const std::string &path, FractionFileFormat format, unsigned threads);
+    extern template std::vector<BasicFraction<__int128>> loadFractions(const std::string &path, FractionFileFormat format, unsigned threads);
+    extern template void saveFractions(const std::string &path, const BasicFraction<int> *begin, const BasicFraction<int> *end, FractionFileFormat format);
+    extern template void saveFractions(const std::string &path, const BasicFraction<int64_t> *begin, const BasicFraction<int64_t> *end, FractionFileFormat format);
+    extern template void saveFractions(const std::string &path, const BasicFraction<__int128> *begin, const BasicFraction<__int128> *end, FractionFileFormat format);
+}
+
+#endif // FRACTIONLOADER_HPP
@@ -0,0 +1,120 @@
+#include "FractionPool.hpp"
+#include <bit>
+#include <limits>
+using namespace std;
+
+namespace ariel
+{
+    namespace
+    {
+        // Block of an id and its offset in the block (see BLOCKS)
+        template <int FIRST_BITS>
+        pair<size_t, size_t> blockOf(uint32_t id)
+        {
+            uint64_t shifted = uint64_t(id) + (uint64_t(1) << FIRST_BITS);
+            auto block = static_cast<size_t>(bit_width(shifted)) - 1 - FIRST_BITS;
+            return {block, static_cast<size_t>(shifted - (uint64_t(1) << (block + FIRST_BITS)))};
+        }
+    }
+
+    template <typename Int>
+    typename BasicFractionPool<Int>::Id BasicFractionPool<Int>::intern(const BasicFraction<Int> &frac)
+    {
+        InternShard &shard = intern_shards[hashValue(frac) % SHARDS];
+        lock_guard lock(shard.mutex);
+        if (const Id *id = shard.ids.find(frac))
+        {
+            return *id;
+        }
+        Id id = append(frac);
+        shard.ids.insert(frac, id);
+        return id;
+    }
+
+    template <typename Int>
+    typename BasicFractionPool<Int>::Id BasicFractionPool<Int>::append(const BasicFraction<Int> &frac)
+    {
+        lock_guard lock(append_mutex);
+        size_t next = count.load(memory_order_relaxed);
+        if (next > numeric_limits<Id>::max())
+        {
+            FRACTION_THROW(length_error, "FractionPool is full");
+        }
+        auto [block, offset] = blockOf<FIRST_BLOCK_BITS>(static_cast<Id>(next));
+        if (offset == 0)
+        {
+            blocks[block] = make_unique<BasicFraction<Int>[]>(size_t(1) << (block + FIRST_BLOCK_BITS));
+        }
+        blocks[block][offset] = frac;
+        // Publishes the value: a reader that sees the new count also sees the block
+        count.store(next + 1, memory_order_release);
+        return static_cast<Id>(next);
+    }
+
+    template <typename Int>
+    const BasicFraction<Int> &BasicFractionPool<Int>::value(Id id) const
+    {
+        if (id >= count.load(memory_order_acquire))
+        {
+            FRACTION_THROW(out_of_range, "Unknown FractionPool id");
+        }
+        auto [block, offset] = blockOf<FIRST_BLOCK_BITS>(id);
+        return blocks[block][offset];
+    }
+
+    template <typename Int>
+    typename BasicFractionPool<Int>::Id BasicFractionPool<Int>::memoized(Operation operation, Id lhs, Id rhs)
+    {
+        const uint64_t key = uint64_t(lhs) << 32 | rhs;
+        ResultShard &shard = result_shards[mixHash(key) % SHARDS];
+        auto &results = shard.results[static_cast<size_t>(operation)];
+        {
+            lock_guard lock(shard.mutex);
+            auto found = results.find(key);
+            if (found != results.end())
+            {
+                return found->second;
+            }
+        }
+        // Computed outside the lock; two threads racing on the same pair intern the same
+        // value and so store the same id
+        Id result = intern(compute(operation, value(lhs), value(rhs)));
+        lock_guard lock(shard.mutex);
+        results.emplace(key, result);
+        return result;
+    }
+
+    template <typename Int>
+    BasicFraction<Int> BasicFractionPool<Int>::compute(Operation operation, const BasicFraction<Int> &lhs, const BasicFraction<Int> &rhs)
+    {
+        switch (operation)
+        {
+        case Operation::Add:
+            return lhs + rhs;
+        case Operation::Subtract:
+            return lhs - rhs;
+        case Operation::Multiply:
+            return lhs * rhs;
+        case Operation::Divide:
+        default:
+            return lhs / rhs;
+        }
+    }
+
+    template <typename Int>
+    void BasicFractionPool<Int>::clearResults()
+    {
+        for (ResultShard &shard : result_shards)
+        {
+            lock_guard lock(shard.mutex);
+            for (auto &results : shard.results)
+            {
+                results.clear();
+            }
+        }
+    }
+
+    template class BasicFractionPool<int>;
+    template class BasicFractionPool<int64_t>;
+    template class BasicFractionPool<__int128>;
+}
@@ -0,0 +1,106 @@
+#ifndef FRACTIONPOOL_HPP
+#define FRACTIONPOOL_HPP
+
+#include "Fraction.hpp"
+#include "FractionHashMap.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace ariel
+{
+    // Thread-safe interning table for data with few distinct values: every distinct
+    // fraction gets a dense 32-bit id, so rows can carry 4-byte ids instead of fractions,
+    // and arithmetic between ids is memoized. The first add/subtract/multiply/divide of a
+    // pair of ids computes and interns the result; every later call for the same pair is
+    // one table lookup, with no gcd.
+    //
+    // Both tables are split into SHARDS shards by hash, each behind its own mutex, so
+    // threads seldom wait on each other. A hit holds the lock for one lookup, which a
+    // plain mutex serves faster than a reader-writer lock. value() takes no lock at all:
+    // values live in blocks that never move, and an id is handed out only after its
+    // value is stored. Ids and values stay valid for the lifetime of the pool. The memo
+    // grows with the number of distinct operand pairs; clearResults() drops it without
+    // touching the ids.
+    template <typename Int>
+    class BasicFractionPool
+    {
+    public:
+        using Id = uint32_t;
+
+        static constexpr size_t SHARDS = 16;
+
+        BasicFractionPool() = default;
+        BasicFractionPool(const BasicFractionPool &) = delete;
+        BasicFractionPool &operator=(const BasicFractionPool &) = delete;
+
+        // Id of frac, assigned on first sight. Throws std::length_error once 2^32 distinct
+        // values have been interned.
+        Id intern(const BasicFraction<Int> &frac);
+        // Value behind id; std::out_of_range for an id this pool never handed out
+        const BasicFraction<Int> &value(Id id) const;
+        // Number of distinct values interned so far; the ids are 0 .. size() - 1
+        size_t size() const { return count.load(std::memory_order_acquire); }
+
+        // Id of value(lhs) op value(rhs), memoized. Errors are those of the operators
+        // (overflow, division by zero) and are not memoized.
+        Id add(Id lhs, Id rhs) { return memoized(Operation::Add, lhs, rhs); }
+        Id subtract(Id lhs, Id rhs) { return memoized(Operation::Subtract, lhs, rhs); }
+        Id multiply(Id lhs, Id rhs) { return memoized(Operation::Multiply, lhs, rhs); }
+        Id divide(Id lhs, Id rhs) { return memoized(Operation::Divide, lhs, rhs); }
+
+        void clearResults();
+
+    private:
+        enum class Operation
+        {
+            Add,
+            Subtract,
+            Multiply,
+            Divide
+        };
+        static constexpr size_t OPERATIONS = 4;
+
+        // Block b holds the 2^(b + FIRST_BLOCK_BITS) ids after those of the blocks before
+        // it, so 27 doubling blocks cover every 32-bit id and none is ever reallocated
+        static constexpr int FIRST_BLOCK_BITS = 6;
+        static constexpr size_t BLOCKS = 33 - FIRST_BLOCK_BITS;
+
+        struct alignas(64) InternShard
+        {
+            std::mutex mutex;
+            BasicFractionHashMap<Int, Id> ids;
+        };
+
+        struct alignas(64) ResultShard
+        {
+            std::mutex mutex;
+            // Keyed by lhs << 32 | rhs, one map per operation
+            std::array<std::unordered_map<uint64_t, Id>, OPERATIONS> results;
+        };
+
+        std::array<InternShard, SHARDS> intern_shards;
+        std::array<ResultShard, SHARDS> result_shards;
+        std::array<std::unique_ptr<BasicFraction<Int>[]>, BLOCKS> blocks;
+        std::mutex append_mutex;
+        std::atomic<size_t> count{0};
+
+        Id append(const BasicFraction<Int> &frac);
+        Id memoized(Operation operation, Id lhs, Id rhs);
+        static BasicFraction<Int> compute(Operation operation, const BasicFraction<Int> &lhs, const BasicFraction<Int> &rhs);
+    };
+
+    using FractionPool = BasicFractionPool<int>;
+    using Fraction64Pool = BasicFractionPool<int64_t>;
+    using Fraction128Pool = BasicFractionPool<__int128>;
+
+    extern template class BasicFractionPool<int>;
+    extern template class BasicFractionPool<int64_t>;
+    extern template class BasicFractionPool<__int128>;
+}
+
+#endif // FRACTIONPOOL_HPP
@@ -0,0 +1,220 @@
+#include "FractionSort.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <thread>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+namespace ariel
+{
+    namespace
+    {
+        constexpr int DIGIT_BITS = 8;
+        constexpr size_t BUCKETS = size_t(1) << DIGIT_BITS;
+        constexpr int PASSES = 32 / DIGIT_BITS;
+
+        template <typename Int>
+        struct KeyedFraction
+        {
+            uint32_t key;
+            BasicFraction<Int> value;
+        };
+
+        // num / den within a relative 2^-50 of the exact quotient. For int both convert exactly and
+        // the division rounds correctly, so the quotient never inverts an order; the wider
+        // backends round on conversion too, and __int128 goes through its 64-bit halves.
+        template <typename Int>
+        double approximateValue(const BasicFraction<Int> &frac)
+        {
+            if constexpr (is_same_v<Int, __int128>)
+            {
+                return approximateDouble(frac.getNumerator()) / approximateDouble(frac.getDenominator());
+            }
+            else
+            {
+                return static_cast<double>(frac.getNumerator()) / static_cast<double>(frac.getDenominator());
+            }
+        }
+
+        // Whether keys never invert two values, so sorting each group of equal keys is enough
+        template <typename Int>
+        constexpr bool EXACT_KEYS = sizeof(Int) <= 4;
+
+        // The top half of the bits of the approximation, as an unsigned integer of the same
+        // order: negative values flip every bit, the others only the sign bit. That keeps
+        // the sign, the exponent and 20 bits of the mantissa.
+        uint32_t sortKey(double value)
+        {
+            auto bits = bit_cast<uint64_t>(value);
+            return static_cast<uint32_t>(((bits >> 63) != 0 ? ~bits : bits | (uint64_t(1) << 63)) >> 32);
+        }
+
+        unsigned threadCount(unsigned requested, size_t size)
+        {
+            if (requested == 0)
+            {
+                requested = max(1U, thread::hardware_concurrency());
+                requested = static_cast<unsigned>(min<size_t>(requested, max<size_t>(1, size / SORT_MIN_CHUNK)));
+            }
+            return static_cast<unsigned>(max<size_t>(1, min<size_t>(requested, size)));
+        }
+
+        // One stable counting pass per key byte. Every thread counts the digits of its own
+        // index range, and the threads then scatter into disjoint slots: bucket by bucket,
+        // and within a bucket in chunk order, which keeps equal digits in input order.
+        template <typename Int>
+        void radixSort(vector<KeyedFraction<Int>> &items, vector<KeyedFraction<Int>> &scratch, unsigned count)
+        {
+            const size_t size = items.size();
+            auto chunkBegin = [size, count](unsigned chunk)
+            { return chunk == count ? size : size / count * chunk; };
+            vector<array<size_t, BUCKETS>> counts(count);
+            for (int pass = 0; pass < PASSES; ++pass)
+            {
+                const int shift = pass * DIGIT_BITS;
+                auto digit = [shift](uint32_t key)
+                { return static_cast<size_t>(key >> shift) & (BUCKETS - 1); };
+                detail::runChunks(count, [&](unsigned chunk)
+                                  {
+                                      counts[chunk].fill(0);
+                                      for (size_t index = chunkBegin(chunk); index < chunkBegin(chunk + 1); ++index)
+                                      {
+                                          ++counts[chunk][digit(items[index].key)];
+                                      } });
+
+                // A byte every key shares (the exponent of values of one magnitude, say)
+                // leaves the order as it is
+                size_t shared = 0;
+                for (const array<size_t, BUCKETS> &chunk_counts : counts)
+                {
+                    shared += chunk_counts[digit(items.front().key)];
+                }
+                if (shared == size)
+                {
+                    continue;
+                }
+
+                size_t offset = 0;
+                for (size_t bucket = 0; bucket < BUCKETS; ++bucket)
+                {
+                    for (array<size_t, BUCKETS> &chunk_counts : counts)
+                    {
+                        size_t bucket_count = chunk_counts[bucket];
+                        chunk_counts[bucket] = offset;
+                        offset += bucket_count;
+                    }
+                }
+                detail::runChunks(count, [&](unsigned chunk)
+                                  {
+                                      array<size_t, BUCKETS> &slots = counts[chunk];
+                                      for (size_t index = chunkBegin(chunk); index < chunkBegin(chunk + 1); ++index)
+                                      {
+                                          scratch[slots[digit(items[index].key)]++] = items[index];
+                                      } });
+                items.swap(scratch);
+            }
+        }
+    }
+
+    template <typename Int>
+    void sortFractions(span<BasicFraction<Int>> values, unsigned threads)
+    {
+        const size_t size = values.size();
+        if (size < SORT_MIN_RADIX)
+        {
+            sort(values.begin(), values.end());
+            return;
+        }
+        const unsigned count = threadCount(threads, size);
+        auto chunkBegin = [size, count](unsigned chunk)
+        { return chunk == count ? size : size / count * chunk; };
+
+        vector<KeyedFraction<Int>> items(size);
+        vector<KeyedFraction<Int>> scratch(size);
+        detail::runChunks(count, [&](unsigned chunk)
+                          {
+                              for (size_t index = chunkBegin(chunk); index < chunkBegin(chunk + 1); ++index)
+                              {
+                                  items[index] = {sortKey(approximateValue(values[index])), values[index]};
+                              } });
+        radixSort(items, scratch, count);
+        vector<KeyedFraction<Int>>().swap(scratch);
+
+        // Every group of equal keys gets the exact order. A group belongs to the chunk it
+        // starts in, and may extend past the end of that chunk.
+        auto groupStart = [&items](size_t index)
+        { return index == 0 || items[index].key != items[index - 1].key; };
+        detail::runChunks(count, [&](unsigned chunk)
+                          {
+                              size_t begin = chunkBegin(chunk);
+                              size_t end = chunkBegin(chunk + 1);
+                              while (begin < end && !groupStart(begin))
+                              {
+                                  ++begin;
+                              }
+                              for (size_t index = begin; index < end; ++index)
+                              {
+                                  values[index] = items[index].value;
+                              }
+                              while (begin < end)
+                              {
+                                  size_t group_end = begin + 1;
+                                  while (group_end < size && !groupStart(group_end))
+                                  {
+                                      ++group_end;
+                                  }
+                                  if (group_end - begin > 1)
+                                  {
+                                      for (size_t index = end; index < group_end; ++index)
+                                      {
+                                          values[index] = items[index].value;
+                                      }
+                                      sort(values.begin() + static_cast<ptrdiff_t>(begin), values.begin() + static_cast<ptrdiff_t>(group_end));
+                                  }
+                                  begin = group_end;
+                              } });
+        if constexpr (EXACT_KEYS<Int>)
+        {
+            return;
+        }
+
+        // Approximate keys can only invert values within about 2^-49 of each other, and a
+        // key group spans 2^-21 or more, so an inversion sits across the boundary of two
+        // neighbouring groups. Both are sorted now: compare the boundary pair exactly and
+        // merge the groups where it is out of order.
+        vector<vector<size_t>> inverted(count);
+        detail::runChunks(count, [&](unsigned chunk)
+                          {
+                              for (size_t index = max<size_t>(1, chunkBegin(chunk)); index < chunkBegin(chunk + 1); ++index)
+                              {
+                                  if (groupStart(index) && values[index] < values[index - 1])
+                                  {
+                                      inverted[chunk].push_back(index);
+                                  }
+                              } });
+        for (const vector<size_t> &boundaries : inverted)
+        {
+            for (size_t boundary : boundaries)
+            {
+                size_t begin = boundary - 1;
+                while (!groupStart(begin))
+                {
+                    --begin;
+                }
+                size_t end = boundary + 1;
+                while (end < size && !groupStart(end))
+                {
+                    ++end;
+                }
+                inplace_merge(values.begin() + static_cast<ptrdiff_t>(begin), values.begin() + static_cast<ptrdiff_t>(boundary), values.begin() + static_cast<ptrdiff_t>(end));
+            }
+        }
+    }
+
+    template void sortFractions(span<BasicFraction<int>> values, unsigned threads);
+    template void sortFractions(span<BasicFraction<int64_t>> values, unsigned threads);
+    template void sortFractions(span<BasicFraction<__int128>> values, unsigned threads);
+}
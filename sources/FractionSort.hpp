@@ -0,0 +1,33 @@
+#ifndef FRACTIONSORT_HPP
+#define FRACTIONSORT_HPP
+
+#include "Fraction.hpp"
+#include <cstddef>
+#include <span>
+
+namespace ariel
+{
+    // Sorts values into the order of operator< on threads threads (0 picks one per core,
+    // with at least SORT_MIN_CHUNK values per thread).
+    //
+    // Each value gets a 32-bit key, the sign, exponent and top mantissa bits of num / den
+    // as a double, and a parallel LSD radix sort orders the keys. Values with equal keys
+    // are then sorted with operator<. The Fraction64 and Fraction128 quotients round on
+    // conversion and can invert two values within about 2^-49 of each other; such a pair
+    // straddles two neighbouring key groups, and those groups are merged exactly. The
+    // result is always exactly the operator< order. Equal fractions are identical (values
+    // are always reduced), so the order among them is not observable.
+    //
+    // Short ranges, below SORT_MIN_RADIX values, go straight to std::sort.
+    template <typename Int>
+    void sortFractions(std::span<BasicFraction<Int>> values, unsigned threads = 0);
+
+    constexpr size_t SORT_MIN_CHUNK = size_t(1) << 16;
+    constexpr size_t SORT_MIN_RADIX = size_t(1) << 10;
+
+    extern template void sortFractions(std::span<BasicFraction<int>> values, unsigned threads);
+    extern template void sortFractions(std::span<BasicFraction<int64_t>> values, unsigned threads);
+    extern template void sortFractions(std::span<BasicFraction<__int128>> values, unsigned threads);
+}
+
+#endif // FRACTIONSORT_HPP
@@ -0,0 +1,260 @@
+#include "FractionWire.hpp"
+using namespace std;
+
+namespace ariel
+{
+    namespace
+    {
+        constexpr uint8_t WIRE_MAGIC[2] = {'F', 'W'};
+        constexpr size_t WIRE_HEADER_SIZE = 4;
+
+        template <typename Unsigned>
+        size_t varintSize(Unsigned value)
+        {
+            size_t size = 1;
+            for (; value >= 0x80; value >>= 7)
+            {
+                ++size;
+            }
+            return size;
+        }
+
+        template <typename Unsigned>
+        uint8_t *putVarint(uint8_t *pos, Unsigned value)
+        {
+            for (; value >= 0x80; value >>= 7)
+            {
+                *pos++ = static_cast<uint8_t>(value | 0x80);
+            }
+            *pos++ = static_cast<uint8_t>(value);
+            return pos;
+        }
+
+        // Reads one varint into value. Throws on truncated input and on values (or
+        // overlong encodings) wider than Unsigned.
+        template <typename Unsigned>
+        const uint8_t *getVarint(const uint8_t *pos, const uint8_t *last, Unsigned &value)
+        {
+            constexpr int BITS = numeric_limits<Unsigned>::digits;
+            // One byte is by far the most common case for small denominators
+            if (pos != last && *pos < 0x80)
+            {
+                value = *pos;
+                return pos + 1;
+            }
+            Unsigned result = 0;
+            for (int shift = 0;; shift += 7)
+            {
+                if (pos == last)
+                {
+                    FRACTION_THROW(runtime_error, "Truncated fraction data");
+                }
+                auto group = static_cast<Unsigned>(*pos & 0x7F);
+                if (shift >= BITS || (BITS - shift < 7 && (group >> (BITS - shift)) != 0))
+                {
+                    FRACTION_THROW(overflow_error, "Overflow in decodeFractions");
+                }
+                result |= static_cast<Unsigned>(group << shift);
+                if ((*pos++ & 0x80) == 0)
+                {
+                    value = result;
+                    return pos;
+                }
+            }
+        }
+
+        template <typename Int>
+        typename FractionTraits<Int>::unsigned_type zigzag(Int value)
+        {
+            using Unsigned = typename FractionTraits<Int>::unsigned_type;
+            return static_cast<Unsigned>(static_cast<Unsigned>(value) << 1) ^ static_cast<Unsigned>(value < 0 ? ~Unsigned(0) : Unsigned(0));
+        }
+
+        template <typename Int>
+        Int unzigzag(typename FractionTraits<Int>::unsigned_type value)
+        {
+            using Unsigned = typename FractionTraits<Int>::unsigned_type;
+            return static_cast<Int>(static_cast<Unsigned>(value >> 1) ^ static_cast<Unsigned>(Unsigned(0) - (value & 1)));
+        }
+
+        // Length of the run of equal denominators starting at index
+        template <typename Int>
+        size_t runLength(span<const BasicFraction<Int>> values, size_t index)
+        {
+            size_t end = index + 1;
+            while (end < values.size() && values[end].getDenominator() == values[index].getDenominator())
+            {
+                ++end;
+            }
+            return end - index;
+        }
+
+        template <typename Int>
+        BasicFraction<Int> decodedFraction(Int num, typename FractionTraits<Int>::unsigned_type den)
+        {
+            if (den == 0)
+            {
+                FRACTION_THROW(runtime_error, "Zero denominator in fraction data");
+            }
+            if (den > static_cast<typename FractionTraits<Int>::unsigned_type>(FractionTraits<Int>::max()))
+            {
+                FRACTION_THROW(overflow_error, "Overflow in decodeFractions");
+            }
+            // Well-formed data is already reduced, but the input is not trusted
+            return BasicFraction<Int>::make(num, static_cast<Int>(den)).value();
+        }
+    }
+
+    template <typename Int>
+    size_t encodedSize(span<const BasicFraction<Int>> values, WireMode mode)
+    {
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+        size_t size = WIRE_HEADER_SIZE + varintSize(values.size());
+        for (size_t index = 0; index < values.size();)
+        {
+            size_t run = mode == WireMode::RunLength ? runLength(values, index) : 1;
+            size += varintSize(static_cast<Unsigned>(values[index].getDenominator()));
+            size += mode == WireMode::RunLength ? varintSize(run) : 0;
+            for (size_t end = index + run; index < end; ++index)
+            {
+                size += varintSize(zigzag(values[index].getNumerator()));
+            }
+        }
+        return size;
+    }
+
+    template <typename Int>
+    size_t encodeFractions(span<const BasicFraction<Int>> values, span<uint8_t> out, WireMode mode)
+    {
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+        if (out.size() < encodedSize(values, mode))
+        {
+            FRACTION_THROW(length_error, "Output too small in encodeFractions");
+        }
+        uint8_t *pos = out.data();
+        *pos++ = WIRE_MAGIC[0];
+        *pos++ = WIRE_MAGIC[1];
+        *pos++ = WIRE_VERSION;
+        *pos++ = static_cast<uint8_t>(mode);
+        pos = putVarint(pos, values.size());
+        if (mode == WireMode::RunLength)
+        {
+            for (size_t index = 0; index < values.size();)
+            {
+                size_t run = runLength(values, index);
+                pos = putVarint(pos, static_cast<Unsigned>(values[index].getDenominator()));
+                pos = putVarint(pos, run);
+                for (size_t end = index + run; index < end; ++index)
+                {
+                    pos = putVarint(pos, zigzag(values[index].getNumerator()));
+                }
+            }
+        }
+        else
+        {
+            for (const BasicFraction<Int> &frac : values)
+            {
+                pos = putVarint(pos, zigzag(frac.getNumerator()));
+                pos = putVarint(pos, static_cast<Unsigned>(frac.getDenominator()));
+            }
+        }
+        return static_cast<size_t>(pos - out.data());
+    }
+
+    size_t decodedCount(span<const uint8_t> in)
+    {
+        if (in.size() < WIRE_HEADER_SIZE || in[0] != WIRE_MAGIC[0] || in[1] != WIRE_MAGIC[1])
+        {
+            FRACTION_THROW(runtime_error, "Not fraction wire data");
+        }
+        if (in[2] != WIRE_VERSION || in[3] > static_cast<uint8_t>(WireMode::RunLength))
+        {
+            FRACTION_THROW(runtime_error, "Unsupported fraction wire version or mode");
+        }
+        uint64_t count = 0;
+        const uint8_t *records = getVarint(in.data() + WIRE_HEADER_SIZE, in.data() + in.size(), count);
+        // Every record takes at least a byte of numerator, and a byte of denominator in
+        // Plain mode, so a count the payload cannot hold is rejected before anyone sizes
+        // a buffer by it
+        const auto payload = static_cast<uint64_t>(in.data() + in.size() - records);
+        if (count > (in[3] == static_cast<uint8_t>(WireMode::Plain) ? payload / 2 : payload))
+        {
+            FRACTION_THROW(runtime_error, "Truncated fraction data");
+        }
+        return static_cast<size_t>(count);
+    }
+
+    template <typename Int>
+    size_t decodeFractions(span<const uint8_t> in, span<BasicFraction<Int>> out)
+    {
+        using Unsigned = typename FractionTraits<Int>::unsigned_type;
+        size_t count = decodedCount(in);
+        if (out.size() < count)
+        {
+            FRACTION_THROW(length_error, "Output too small in decodeFractions");
+        }
+        const uint8_t *last = in.data() + in.size();
+        uint64_t header_count = 0;
+        const uint8_t *pos = getVarint(in.data() + WIRE_HEADER_SIZE, last, header_count);
+        Unsigned num = 0;
+        Unsigned den = 0;
+        if (static_cast<WireMode>(in[3]) == WireMode::RunLength)
+        {
+            for (size_t index = 0; index < count;)
+            {
+                uint64_t run = 0;
+                pos = getVarint(getVarint(pos, last, den), last, run);
+                if (run == 0 || run > count - index)
+                {
+                    FRACTION_THROW(runtime_error, "Invalid run length in fraction data");
+                }
+                for (size_t end = index + static_cast<size_t>(run); index < end; ++index)
+                {
+                    pos = getVarint(pos, last, num);
+                    out[index] = decodedFraction(unzigzag<Int>(num), den);
+                }
+            }
+        }
+        else
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                pos = getVarint(getVarint(pos, last, num), last, den);
+                out[index] = decodedFraction(unzigzag<Int>(num), den);
+            }
+        }
+        return static_cast<size_t>(pos - in.data());
+    }
+
+    template <typename Int>
+    vector<uint8_t> encodeFractions(span<const BasicFraction<Int>> values, WireMode mode)
+    {
+        vector<uint8_t> bytes(encodedSize(values, mode));
+        encodeFractions(values, span<uint8_t>(bytes), mode);
+        return bytes;
+    }
+
+    template <typename Int>
+    vector<BasicFraction<Int>> decodeFractions(span<const uint8_t> in)
+    {
+        vector<BasicFraction<Int>> values(decodedCount(in));
+        decodeFractions(in, span<BasicFraction<Int>>(values));
+        return values;
+    }
+
+    template size_t encodedSize(span<const BasicFraction<int>> values, WireMode mode);
+    template size_t encodedSize(span<const BasicFraction<int64_t>> values, WireMode mode);
+    template size_t encodedSize(span<const BasicFraction<__int128>> values, WireMode mode);
+    template size_t encodeFractions(span<const BasicFraction<int>> values, span<uint8_t> out, WireMode mode);
+    template size_t encodeFractions(span<const BasicFraction<int64_t>> values, span<uint8_t> out, WireMode mode);
+    template size_t encodeFractions(span<const BasicFraction<__int128>> values, span<uint8_t> out, WireMode mode);
+    template size_t decodeFractions(span<const uint8_t> in, span<BasicFraction<int>> out);
+    template size_t decodeFractions(span<const uint8_t> in, span<BasicFraction<int64_t>> out);
+    template size_t decodeFractions(span<const uint8_t> in, span<BasicFraction<__int128>> out);
+    template vector<uint8_t> encodeFractions(span<const BasicFraction<int>> values, WireMode mode);
+    template vector<uint8_t> encodeFractions(span<const BasicFraction<int64_t>> values, WireMode mode);
+    template vector<uint8_t> encodeFractions(span<const BasicFraction<__int128>> values, WireMode mode);
+    template vector<BasicFraction<int>> decodeFractions(span<const uint8_t> in);
+    template vector<BasicFraction<int64_t>> decodeFractions(span<const uint8_t> in);
+    template vector<BasicFraction<__int128>> decodeFractions(span<const uint8_t> in);
+}
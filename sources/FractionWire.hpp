@@ -0,0 +1,77 @@
+#ifndef FRACTIONWIRE_HPP
+#define FRACTIONWIRE_HPP
+
+#include "Fraction.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ariel
+{
+    // Compact binary wire format, independent of the Int width:
+    //
+    //   header     'F' 'W', version byte (1), mode byte, varint record count
+    //   Plain      per record: zigzag varint numerator, varint denominator
+    //   RunLength  runs of equal denominators: varint denominator, varint run length,
+    //              then a zigzag varint numerator per record of the run
+    //
+    // Varints are LEB128 (7 bits per byte, low group first) and zigzag maps 0, -1, 1, -2,
+    // ... to 0, 1, 2, 3, ..., so small values of either sign take one byte. RunLength
+    // suits columns that share a denominator (prices in cents, fixed-point feeds).
+    enum class WireMode : uint8_t
+    {
+        Plain = 0,
+        RunLength = 1
+    };
+
+    constexpr uint8_t WIRE_VERSION = 1;
+
+    // The functions below take spans over caller memory and never copy the records. Name
+    // Int explicitly (encodeFractions<int>(values, ...)) so containers convert to spans.
+
+    // Exact number of bytes encodeFractions writes for values
+    template <typename Int>
+    size_t encodedSize(std::span<const BasicFraction<Int>> values, WireMode mode = WireMode::Plain);
+
+    // Encodes values into out and returns the number of bytes written. Throws
+    // std::length_error when out is shorter than encodedSize(values, mode).
+    template <typename Int>
+    size_t encodeFractions(std::span<const BasicFraction<Int>> values, std::span<uint8_t> out, WireMode mode = WireMode::Plain);
+
+    // Record count from the header of an encoded buffer. Throws std::runtime_error when
+    // the rest of the buffer is too short to hold that many records, so the count is
+    // safe to size an allocation with.
+    size_t decodedCount(std::span<const uint8_t> in);
+
+    // Decodes the records of in into out, which needs decodedCount(in) elements, and
+    // returns the number of bytes consumed. Each value is reduced like the constructor
+    // reduces it. Malformed or truncated input throws std::runtime_error, values that do
+    // not fit in Int std::overflow_error and a short out std::length_error.
+    template <typename Int>
+    size_t decodeFractions(std::span<const uint8_t> in, std::span<BasicFraction<Int>> out);
+
+    // Convenience forms that allocate
+    template <typename Int>
+    std::vector<uint8_t> encodeFractions(std::span<const BasicFraction<Int>> values, WireMode mode = WireMode::Plain);
+    template <typename Int>
+    std::vector<BasicFraction<Int>> decodeFractions(std::span<const uint8_t> in);
+
+    extern template size_t encodedSize(std::span<const BasicFraction<int>> values, WireMode mode);
+    extern template size_t encodedSize(std::span<const BasicFraction<int64_t>> values, WireMode mode);
+    extern template size_t encodedSize(std::span<const BasicFraction<__int128>> values, WireMode mode);
+    extern template size_t encodeFractions(std::span<const BasicFraction<int>> values, std::span<uint8_t> out, WireMode mode);
+    extern template size_t encodeFractions(std::span<const BasicFraction<int64_t>> values, std::span<uint8_t> out, WireMode mode);
+    extern template size_t encodeFractions(std::span<const BasicFraction<__int128>> values, std::span<uint8_t> out, WireMode mode);
+    extern template size_t decodeFractions(std::span<const uint8_t> in, std::span<BasicFraction<int>> out);
+    extern template size_t decodeFractions(std::span<const uint8_t> in, std::span<BasicFraction<int64_t>> out);
+    extern template size_t decodeFractions(std::span<const uint8_t> in, std::span<BasicFraction<__int128>> out);
+    extern template std::vector<uint8_t> encodeFractions(std::span<const BasicFraction<int>> values, WireMode mode);
+    extern template std::vector<uint8_t> encodeFractions(std::span<const BasicFraction<int64_t>> values, WireMode mode);
+    extern template std::vector<uint8_t> encodeFractions(std::span<const BasicFraction<__int128>> values, WireMode mode);
+    extern template std::vector<BasicFraction<int>> decodeFractions(std::span<const uint8_t> in);
+    extern template std::vector<BasicFraction<int64_t>> decodeFractions(std::span<const uint8_t> in);
+    extern template std::vector<BasicFraction<__int128>> decodeFractions(std::span<const uint8_t> in);
+}
+
+#endif // FRACTIONWIRE_HPP
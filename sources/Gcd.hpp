@@ -0,0 +1,175 @@
+#ifndef GCD_HPP
+#define GCD_HPP
+
+#include <cstdint>
+#include <utility>
+
+namespace ariel
+{
+    // GCD kernels used by reduce(). All of them work on unsigned magnitudes, so the
+    // callers take care of signs and of the most negative value.
+    enum class GcdKernel
+    {
+        Euclid,
+        Stein,
+        Lehmer
+    };
+
+    // Kernel used by Fraction::reduce(). Override with -DFRACTION_GCD_KERNEL=Euclid (or Lehmer).
+#ifndef FRACTION_GCD_KERNEL
+#define FRACTION_GCD_KERNEL Stein
+#endif
+    constexpr GcdKernel DEFAULT_GCD_KERNEL = GcdKernel::FRACTION_GCD_KERNEL;
+
+    constexpr int trailingZeros(unsigned int value) { return __builtin_ctz(value); }
+    constexpr int trailingZeros(unsigned long value) { return __builtin_ctzl(value); }
+    constexpr int trailingZeros(unsigned long long value) { return __builtin_ctzll(value); }
+    constexpr int trailingZeros(unsigned __int128 value)
+    {
+        auto low = static_cast<uint64_t>(value);
+        return low != 0 ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<uint64_t>(value >> 64));
+    }
+
+    constexpr int leadingZeros(unsigned int value) { return __builtin_clz(value); }
+    constexpr int leadingZeros(unsigned long value) { return __builtin_clzl(value); }
+    constexpr int leadingZeros(unsigned long long value) { return __builtin_clzll(value); }
+    constexpr int leadingZeros(unsigned __int128 value)
+    {
+        auto high = static_cast<uint64_t>(value >> 64);
+        return high != 0 ? __builtin_clzll(high) : 64 + __builtin_clzll(static_cast<uint64_t>(value));
+    }
+
+    // Division-based Euclid, the algorithm behind std::__gcd
+    template <typename Unsigned>
+    constexpr Unsigned euclidGcd(Unsigned lhs, Unsigned rhs)
+    {
+        while (rhs != 0)
+        {
+            Unsigned rem = lhs % rhs;
+            lhs = rhs;
+            rhs = rem;
+        }
+        return lhs;
+    }
+
+    // Binary GCD (Stein). Strips common powers of two with a trailing-zero count and then
+    // only subtracts and shifts, so the loop never hits the divider. The trailing zeros of
+    // the next operand are taken from the difference, which keeps min/abs branch-free.
+    template <typename Unsigned>
+    constexpr Unsigned steinGcd(Unsigned lhs, Unsigned rhs)
+    {
+        if (lhs == 0)
+        {
+            return rhs;
+        }
+        if (rhs == 0)
+        {
+            return lhs;
+        }
+        int lhs_zeros = trailingZeros(lhs);
+        int rhs_zeros = trailingZeros(rhs);
+        int shift = lhs_zeros < rhs_zeros ? lhs_zeros : rhs_zeros;
+        rhs >>= rhs_zeros;
+        while (lhs != 0)
+        {
+            lhs >>= lhs_zeros;
+            auto diff = static_cast<Unsigned>(rhs - lhs);
+            lhs_zeros = diff == 0 ? 0 : trailingZeros(diff);
+            Unsigned low = lhs < rhs ? lhs : rhs;
+            lhs = lhs < rhs ? diff : static_cast<Unsigned>(lhs - rhs);
+            rhs = low;
+        }
+        return static_cast<Unsigned>(rhs << shift);
+    }
+
+    // Lehmer's GCD (Knuth, TAOCP 4.5.2 Algorithm L). Runs Euclid on the leading bits of
+    // both operands to batch several quotient steps into one 2x2 cosequence update, and
+    // finishes with plain Euclid once the operands fit in a single digit.
+    template <typename Unsigned>
+    constexpr Unsigned lehmerGcd(Unsigned lhs, Unsigned rhs)
+    {
+        constexpr int WIDTH = static_cast<int>(sizeof(Unsigned) * 8);
+        constexpr int DIGIT = WIDTH / 2 < 32 ? WIDTH / 2 : 32;
+        if (lhs < rhs)
+        {
+            std::swap(lhs, rhs);
+        }
+        while ((rhs >> DIGIT) != 0)
+        {
+            int shift = WIDTH - leadingZeros(lhs) - DIGIT;
+            auto lead_lhs = static_cast<int64_t>(lhs >> shift);
+            auto lead_rhs = static_cast<int64_t>(rhs >> shift);
+            int64_t a = 1;
+            int64_t b = 0;
+            int64_t c = 0;
+            int64_t d = 1;
+            while (lead_rhs + c != 0 && lead_rhs + d != 0)
+            {
+                int64_t quot = (lead_lhs + a) / (lead_rhs + c);
+                if (quot != (lead_lhs + b) / (lead_rhs + d))
+                {
+                    break;
+                }
+                int64_t next = a - quot * c;
+                a = c;
+                c = next;
+                next = b - quot * d;
+                b = d;
+                d = next;
+                next = lead_lhs - quot * lead_rhs;
+                lead_lhs = lead_rhs;
+                lead_rhs = next;
+            }
+            if (b == 0)
+            {
+                Unsigned rem = lhs % rhs;
+                lhs = rhs;
+                rhs = rem;
+            }
+            else
+            {
+                // The true results lie in [0, lhs], so wrapping unsigned arithmetic is exact
+                Unsigned next_lhs = static_cast<Unsigned>(static_cast<Unsigned>(a) * lhs + static_cast<Unsigned>(b) * rhs);
+                Unsigned next_rhs = static_cast<Unsigned>(static_cast<Unsigned>(c) * lhs + static_cast<Unsigned>(d) * rhs);
+                lhs = next_lhs;
+                rhs = next_rhs;
+            }
+        }
+        return euclidGcd(lhs, rhs);
+    }
+
+    template <GcdKernel Kernel = DEFAULT_GCD_KERNEL, typename Unsigned>
+    constexpr Unsigned kernelGcd(Unsigned lhs, Unsigned rhs)
+    {
+        if constexpr (Kernel == GcdKernel::Euclid)
+        {
+            return euclidGcd(lhs, rhs);
+        }
+        else if constexpr (Kernel == GcdKernel::Stein)
+        {
+            return steinGcd(lhs, rhs);
+        }
+        else
+        {
+            return lehmerGcd(lhs, rhs);
+        }
+    }
+
+    // Runtime selection, for benchmarks and for callers that pick a kernel per workload
+    template <typename Unsigned>
+    constexpr Unsigned kernelGcd(GcdKernel kernel, Unsigned lhs, Unsigned rhs)
+    {
+        switch (kernel)
+        {
+        case GcdKernel::Euclid:
+            return euclidGcd(lhs, rhs);
+        case GcdKernel::Lehmer:
+            return lehmerGcd(lhs, rhs);
+        case GcdKernel::Stein:
+        default:
+            return steinGcd(lhs, rhs);
+        }
+    }
+}
+
+#endif // GCD_HPP
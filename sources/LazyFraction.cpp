@@ -0,0 +1,173 @@
+#include "LazyFraction.hpp"
+#include <stdexcept>
+#include <utility>
+using namespace std;
+
+namespace ariel
+{
+
+    template <typename Int>
+    BasicLazyFraction<Int>::BasicLazyFraction(Int numerator, Int denominator) : numerator(numerator), denominator(denominator), normalized(false)
+    {
+        if (denominator == 0)
+        {
+            FRACTION_THROW(std::invalid_argument, "Denominator cannot be zero");
+        }
+    }
+
+    template <typename Int>
+    BasicLazyFraction<Int>::BasicLazyFraction(const BasicFraction<Int> &frac)
+        : numerator(frac.getNumerator()), denominator(frac.getDenominator()), normalized(true)
+    {
+    }
+
+    template <typename Int>
+    void BasicLazyFraction<Int>::normalize()
+    {
+        if (!normalized)
+        {
+            assign(BasicFraction<Int>(numerator, denominator));
+        }
+    }
+
+    template <typename Int>
+    Int BasicLazyFraction<Int>::getNumerator()
+    {
+        normalize();
+        return numerator;
+    }
+
+    template <typename Int>
+    Int BasicLazyFraction<Int>::getDenominator()
+    {
+        normalize();
+        return denominator;
+    }
+
+    template <typename Int>
+    BasicFraction<Int> BasicLazyFraction<Int>::toFraction()
+    {
+        normalize();
+        return std::as_const(*this).toFraction();
+    }
+
+    // Reduced fields go in as they are; otherwise the reduction lands in the result only
+    template <typename Int>
+    BasicFraction<Int> BasicLazyFraction<Int>::toFraction() const
+    {
+        if (!normalized)
+        {
+            return BasicFraction<Int>(numerator, denominator);
+        }
+        return BasicFraction<Int>::fromReduced(ReducedKey(), numerator, denominator);
+    }
+
+    // Raw a/b +- c/d without reducing. Leaves *this untouched and returns false if any
+    // intermediate would overflow Int.
+    template <typename Int>
+    bool BasicLazyFraction<Int>::tryAdd(const BasicLazyFraction &frac, bool subtract)
+    {
+        Int num = 0;
+        Int den = denominator;
+        if (denominator == frac.denominator)
+        {
+            // Shared denominators (fixed-denominator feeds) only touch the numerators
+            if (subtract ? __builtin_sub_overflow(numerator, frac.numerator, &num)
+                         : __builtin_add_overflow(numerator, frac.numerator, &num))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            Int lhs = 0;
+            Int rhs = 0;
+            if (__builtin_mul_overflow(numerator, frac.denominator, &lhs) ||
+                __builtin_mul_overflow(frac.numerator, denominator, &rhs) ||
+                (subtract ? __builtin_sub_overflow(lhs, rhs, &num) : __builtin_add_overflow(lhs, rhs, &num)) ||
+                __builtin_mul_overflow(denominator, frac.denominator, &den))
+            {
+                return false;
+            }
+        }
+        numerator = num;
+        denominator = den;
+        normalized = false;
+        return true;
+    }
+
+    template <typename Int>
+    bool BasicLazyFraction<Int>::tryMultiply(Int num, Int den)
+    {
+        Int new_num = 0;
+        Int new_den = 0;
+        if (__builtin_mul_overflow(numerator, num, &new_num) || __builtin_mul_overflow(denominator, den, &new_den))
+        {
+            return false;
+        }
+        numerator = new_num;
+        denominator = new_den;
+        normalized = false;
+        return true;
+    }
+
+    template <typename Int>
+    void BasicLazyFraction<Int>::assign(const BasicFraction<Int> &frac)
+    {
+        numerator = frac.getNumerator();
+        denominator = frac.getDenominator();
+        normalized = true;
+    }
+
+    // Each operator first tries the unreduced step. Only when that would overflow does it
+    // fall back to the reduced Fraction operator, so the result and any overflow_error
+    // match what Fraction computes.
+    template <typename Int>
+    BasicLazyFraction<Int> &BasicLazyFraction<Int>::operator+=(const BasicLazyFraction &frac)
+    {
+        if (!tryAdd(frac, false))
+        {
+            assign(toFraction() + frac.toFraction());
+        }
+        return *this;
+    }
+
+    template <typename Int>
+    BasicLazyFraction<Int> &BasicLazyFraction<Int>::operator-=(const BasicLazyFraction &frac)
+    {
+        if (!tryAdd(frac, true))
+        {
+            assign(toFraction() - frac.toFraction());
+        }
+        return *this;
+    }
+
+    template <typename Int>
+    BasicLazyFraction<Int> &BasicLazyFraction<Int>::operator*=(const BasicLazyFraction &frac)
+    {
+        if (!tryMultiply(frac.numerator, frac.denominator))
+        {
+            assign(toFraction() * frac.toFraction());
+        }
+        return *this;
+    }
+
+    template <typename Int>
+    BasicLazyFraction<Int> &BasicLazyFraction<Int>::operator/=(const BasicLazyFraction &frac)
+    {
+        if (frac.numerator == 0)
+        {
+            FRACTION_THROW(std::runtime_error, "Denominator cannot be zero");
+        }
+        if (!tryMultiply(frac.denominator, frac.numerator))
+        {
+            assign(toFraction() / frac.toFraction());
+        }
+        return *this;
+    }
+
+    template class BasicLazyFraction<int>;
+    template class BasicLazyFraction<int64_t>;
+    template class BasicLazyFraction<__int128>;
+
+}
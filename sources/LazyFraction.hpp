@@ -0,0 +1,69 @@
+#ifndef LAZYFRACTION_HPP
+#define LAZYFRACTION_HPP
+
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    // Unreduced accumulator over the same backends as BasicFraction.
+    // Arithmetic carries numerator and denominator as they come out of the cross products
+    // and only reduces when a step would overflow Int, or when the value is
+    // observed: comparisons, getNumerator()/getDenominator(), toFraction() and operator<<.
+    // Long summation chains therefore pay for one GCD at the end instead of one per step.
+    //
+    // Only the non-const observers store the reduced value back. The const ones (const
+    // toFraction(), the comparisons, operator<<) reduce into a local copy and never write,
+    // so a const value can be read from several threads like any other.
+    template <typename Int>
+    class BasicLazyFraction
+    {
+    private:
+        Int numerator, denominator;
+        bool normalized;
+
+        void assign(const BasicFraction<Int> &frac);
+        bool tryAdd(const BasicLazyFraction &frac, bool subtract);
+        bool tryMultiply(Int num, Int den);
+
+    public:
+        BasicLazyFraction(Int num = 0, Int den = 1);
+        BasicLazyFraction(const BasicFraction<Int> &frac);
+
+        // Reduce in place, so later observations cost no gcd
+        void normalize();
+        Int getNumerator();
+        Int getDenominator();
+        bool isNormalized() const { return normalized; }
+        BasicFraction<Int> toFraction();
+        BasicFraction<Int> toFraction() const;
+
+        BasicLazyFraction &operator+=(const BasicLazyFraction &frac);
+        BasicLazyFraction &operator-=(const BasicLazyFraction &frac);
+        BasicLazyFraction &operator*=(const BasicLazyFraction &frac);
+        BasicLazyFraction &operator/=(const BasicLazyFraction &frac);
+
+        friend BasicLazyFraction operator+(BasicLazyFraction other, const BasicLazyFraction &frac) { return other += frac; }
+        friend BasicLazyFraction operator-(BasicLazyFraction other, const BasicLazyFraction &frac) { return other -= frac; }
+        friend BasicLazyFraction operator*(BasicLazyFraction other, const BasicLazyFraction &frac) { return other *= frac; }
+        friend BasicLazyFraction operator/(BasicLazyFraction other, const BasicLazyFraction &frac) { return other /= frac; }
+
+        friend bool operator==(const BasicLazyFraction &other, const BasicLazyFraction &frac) { return other.toFraction() == frac.toFraction(); }
+        friend bool operator!=(const BasicLazyFraction &other, const BasicLazyFraction &frac) { return other.toFraction() != frac.toFraction(); }
+        friend bool operator>(const BasicLazyFraction &other, const BasicLazyFraction &frac) { return other.toFraction() > frac.toFraction(); }
+        friend bool operator<(const BasicLazyFraction &other, const BasicLazyFraction &frac) { return other.toFraction() < frac.toFraction(); }
+        friend bool operator>=(const BasicLazyFraction &other, const BasicLazyFraction &frac) { return other.toFraction() >= frac.toFraction(); }
+        friend bool operator<=(const BasicLazyFraction &other, const BasicLazyFraction &frac) { return other.toFraction() <= frac.toFraction(); }
+
+        friend std::ostream &operator<<(std::ostream &ost, const BasicLazyFraction &frac) { return ost << frac.toFraction(); }
+    };
+
+    using LazyFraction = BasicLazyFraction<int>;
+    using LazyFraction64 = BasicLazyFraction<int64_t>;
+    using LazyFraction128 = BasicLazyFraction<__int128>;
+
+    extern template class BasicLazyFraction<int>;
+    extern template class BasicLazyFraction<int64_t>;
+    extern template class BasicLazyFraction<__int128>;
+}
+
+#endif // LAZYFRACTION_HPP
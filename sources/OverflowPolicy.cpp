@@ -0,0 +1,73 @@
+#include "OverflowPolicy.hpp"
+using namespace std;
+
+namespace ariel
+{
+
+    template <typename Int>
+    BasicFraction<Int> nearestRepresentable(const BigFraction &exact)
+    {
+        bool negative = exact.getNumerator().isNegative();
+        BigInteger num = exact.getNumerator().abs();
+        BigInteger den = exact.getDenominator();
+
+        // min has one more unit of magnitude than max, so negative values may use it
+        BigInteger den_limit(FractionTraits<Int>::max());
+        BigInteger num_limit = negative ? -BigInteger(FractionTraits<Int>::min()) : den_limit;
+        auto build = [negative](const BigInteger &mag_num, const BigInteger &mag_den)
+        {
+            BigInteger signed_num = negative ? -mag_num : mag_num;
+            return BasicFraction<Int>(static_cast<Int>(signed_num.toInt128()), static_cast<Int>(mag_den.toInt128()));
+        };
+        if (num / den >= num_limit)
+        {
+            return negative ? BasicFraction<Int>(FractionTraits<Int>::min()) : BasicFraction<Int>(FractionTraits<Int>::max());
+        }
+
+        // Convergents h/k of num/den; the first one is floor(num/den), which fits
+        BigInteger prev_num(0), prev_den(1), last_num(1), last_den(0);
+        while (!den.isZero())
+        {
+            BigInteger quot, rem;
+            BigInteger::divmod(num, den, quot, rem);
+            BigInteger next_num = quot * last_num + prev_num;
+            BigInteger next_den = quot * last_den + prev_den;
+            if (next_num > num_limit || next_den > den_limit)
+            {
+                // Largest semiconvergent that still fits, compared with the last convergent
+                BigInteger steps = (den_limit - prev_den) / last_den;
+                if (!last_num.isZero())
+                {
+                    BigInteger num_steps = (num_limit - prev_num) / last_num;
+                    steps = num_steps < steps ? num_steps : steps;
+                }
+                BigInteger semi_num = steps * last_num + prev_num;
+                BigInteger semi_den = steps * last_den + prev_den;
+                BigFraction target(exact.getNumerator().abs(), exact.getDenominator());
+                if (!steps.isZero())
+                {
+                    BigFraction semi_error = BigFraction(semi_num, semi_den) - target;
+                    BigFraction last_error = BigFraction(last_num, last_den) - target;
+                    if ((semi_error < BigFraction(0) ? BigFraction(0) - semi_error : semi_error) <
+                        (last_error < BigFraction(0) ? BigFraction(0) - last_error : last_error))
+                    {
+                        return build(semi_num, semi_den);
+                    }
+                }
+                return build(last_num, last_den);
+            }
+            prev_num = last_num;
+            prev_den = last_den;
+            last_num = next_num;
+            last_den = next_den;
+            num = den;
+            den = rem;
+        }
+        return build(last_num, last_den);
+    }
+
+    template BasicFraction<int> nearestRepresentable<int>(const BigFraction &exact);
+    template BasicFraction<int64_t> nearestRepresentable<int64_t>(const BigFraction &exact);
+    template BasicFraction<__int128> nearestRepresentable<__int128>(const BigFraction &exact);
+
+}
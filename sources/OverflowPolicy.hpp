@@ -0,0 +1,224 @@
+#ifndef OVERFLOWPOLICY_HPP
+#define OVERFLOWPOLICY_HPP
+
+#include "Fraction.hpp"
+#include "BigFraction.hpp"
+#include <type_traits>
+
+namespace ariel
+{
+    enum class FractionOp
+    {
+        Add,
+        Subtract,
+        Multiply,
+        Divide
+    };
+
+    template <FractionOp op, typename Int>
+    Checked<BasicFraction<Int>> checkedApply(const BasicFraction<Int> &other, const BasicFraction<Int> &frac)
+    {
+        if constexpr (op == FractionOp::Add)
+        {
+            return checkedAdd(other, frac);
+        }
+        else if constexpr (op == FractionOp::Subtract)
+        {
+            return checkedSubtract(other, frac);
+        }
+        else if constexpr (op == FractionOp::Multiply)
+        {
+            return checkedMultiply(other, frac);
+        }
+        else
+        {
+            return checkedDivide(other, frac);
+        }
+    }
+
+    // The plain operator for op, for types whose operators cannot overflow
+    template <FractionOp op, typename Value>
+    Value applyOperator(const Value &other, const Value &frac)
+    {
+        if constexpr (op == FractionOp::Add)
+        {
+            return other + frac;
+        }
+        else if constexpr (op == FractionOp::Subtract)
+        {
+            return other - frac;
+        }
+        else if constexpr (op == FractionOp::Multiply)
+        {
+            return other * frac;
+        }
+        else
+        {
+            return other / frac;
+        }
+    }
+
+    constexpr const char *operatorName(FractionOp op)
+    {
+        switch (op)
+        {
+        case FractionOp::Add:
+            return "operator+";
+        case FractionOp::Subtract:
+            return "operator-";
+        case FractionOp::Multiply:
+            return "operator*";
+        case FractionOp::Divide:
+        default:
+            return "operator/";
+        }
+    }
+
+    // The representable BasicFraction<Int> closest to exact: ±max (or min) when the value
+    // is out of range, otherwise the best approximation whose numerator and denominator
+    // both fit, taken from the continued fraction convergents and semiconvergents.
+    template <typename Int>
+    BasicFraction<Int> nearestRepresentable(const BigFraction &exact);
+
+    // Overflow policies for PolicyFraction. Each one only decides what happens once the
+    // exact core reports an error, so the common path is the same code as the plain
+    // operators and the policy picks the cheapest check for its use:
+    //
+    //   ThrowOnOverflow     the plain Fraction behaviour
+    //   SaturateOnOverflow  the nearest representable rational instead of overflow_error
+    //   PromoteOnOverflow   results in the next wider type, so there is nothing to check
+    //   StickyOverflow      zero and a thread-local flag the caller checks once per batch
+    //
+    // Division by zero is not an overflow and keeps throwing, except under StickyOverflow.
+    struct ThrowOnOverflow
+    {
+        template <typename Int>
+        using result_type = BasicFraction<Int>;
+
+        template <FractionOp op, typename Int>
+        static BasicFraction<Int> apply(const BasicFraction<Int> &other, const BasicFraction<Int> &frac)
+        {
+            Checked<BasicFraction<Int>> result = checkedApply<op>(other, frac);
+            if (!result)
+            {
+                raise(result.error(), operatorName(op));
+            }
+            return *result;
+        }
+    };
+
+    struct SaturateOnOverflow
+    {
+        template <typename Int>
+        using result_type = BasicFraction<Int>;
+
+        template <FractionOp op, typename Int>
+        static BasicFraction<Int> apply(const BasicFraction<Int> &other, const BasicFraction<Int> &frac)
+        {
+            Checked<BasicFraction<Int>> result = checkedApply<op>(other, frac);
+            if (result)
+            {
+                return *result;
+            }
+            if (result.error() != FractionError::Overflow)
+            {
+                raise(result.error(), operatorName(op));
+            }
+            return nearestRepresentable<Int>(applyOperator<op>(BigFraction(other), BigFraction(frac)));
+        }
+    };
+
+    // Type the promoting policy computes in: every result of two Int operands fits there
+    template <typename Int>
+    struct Promoted
+    {
+        using type = BasicFraction<typename FractionTraits<Int>::wide_type>;
+    };
+
+    template <>
+    struct Promoted<__int128>
+    {
+        using type = BigFraction;
+    };
+
+    struct PromoteOnOverflow
+    {
+        template <typename Int>
+        using result_type = typename Promoted<Int>::type;
+
+        template <FractionOp op, typename Int>
+        static result_type<Int> apply(const BasicFraction<Int> &other, const BasicFraction<Int> &frac)
+        {
+            return applyOperator<op>(result_type<Int>(other), result_type<Int>(frac));
+        }
+    };
+
+    struct StickyOverflow
+    {
+        template <typename Int>
+        using result_type = BasicFraction<Int>;
+
+        // First error since the last clear() on this thread
+        static FractionError status() { return first_error; }
+        static void clear() { first_error = FractionError::None; }
+
+        template <FractionOp op, typename Int>
+        static BasicFraction<Int> apply(const BasicFraction<Int> &other, const BasicFraction<Int> &frac)
+        {
+            Checked<BasicFraction<Int>> result = checkedApply<op>(other, frac);
+            if (!result)
+            {
+                if (first_error == FractionError::None)
+                {
+                    first_error = result.error();
+                }
+                return BasicFraction<Int>();
+            }
+            return *result;
+        }
+
+    private:
+        static inline thread_local FractionError first_error = FractionError::None;
+    };
+
+    // BasicFraction<Int> whose arithmetic operators follow Policy on overflow.
+    // PolicyFraction<SaturateOnOverflow> a(1, 3), b(2, 5); a * b stays a PolicyFraction,
+    // while PromoteOnOverflow results are plain values of the wider type.
+    template <typename Policy, typename Int = int>
+    class PolicyFraction
+    {
+    private:
+        using PolicyResult = typename Policy::template result_type<Int>;
+        using Result = std::conditional_t<std::is_same_v<PolicyResult, BasicFraction<Int>>, PolicyFraction, PolicyResult>;
+
+        BasicFraction<Int> value;
+
+    public:
+        PolicyFraction(Int num = 0, Int den = 1) : value(num, den) {}
+        PolicyFraction(const BasicFraction<Int> &frac) : value(frac) {}
+
+        const BasicFraction<Int> &fraction() const { return value; }
+        Int getNumerator() const { return value.getNumerator(); }
+        Int getDenominator() const { return value.getDenominator(); }
+
+        friend Result operator+(const PolicyFraction &other, const PolicyFraction &frac) { return Policy::template apply<FractionOp::Add>(other.value, frac.value); }
+        friend Result operator-(const PolicyFraction &other, const PolicyFraction &frac) { return Policy::template apply<FractionOp::Subtract>(other.value, frac.value); }
+        friend Result operator*(const PolicyFraction &other, const PolicyFraction &frac) { return Policy::template apply<FractionOp::Multiply>(other.value, frac.value); }
+        friend Result operator/(const PolicyFraction &other, const PolicyFraction &frac) { return Policy::template apply<FractionOp::Divide>(other.value, frac.value); }
+
+        friend bool operator==(const PolicyFraction &other, const PolicyFraction &frac) { return other.value == frac.value; }
+        friend bool operator!=(const PolicyFraction &other, const PolicyFraction &frac) { return other.value != frac.value; }
+        friend bool operator<(const PolicyFraction &other, const PolicyFraction &frac) { return other.value < frac.value; }
+        friend bool operator>(const PolicyFraction &other, const PolicyFraction &frac) { return other.value > frac.value; }
+        friend bool operator<=(const PolicyFraction &other, const PolicyFraction &frac) { return other.value <= frac.value; }
+        friend bool operator>=(const PolicyFraction &other, const PolicyFraction &frac) { return other.value >= frac.value; }
+
+        friend std::ostream &operator<<(std::ostream &ost, const PolicyFraction &frac) { return ost << frac.value; }
+    };
+
+    extern template BasicFraction<int> nearestRepresentable<int>(const BigFraction &exact);
+    extern template BasicFraction<int64_t> nearestRepresentable<int64_t>(const BigFraction &exact);
+    extern template BasicFraction<__int128> nearestRepresentable<__int128>(const BigFraction &exact);
+}
+
+#endif // OVERFLOWPOLICY_HPP
@@ -0,0 +1,76 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace ariel
+{
+    // Thread helpers shared by the bulk operations (loader, sort). Named and inline like
+    // the helpers of FractionImpl.hpp, since several translation units use them.
+    namespace detail
+    {
+        // Joins its threads however the scope is left, so none is destroyed joinable
+        struct JoinGuard
+        {
+            std::vector<std::thread> threads;
+
+            JoinGuard() = default;
+            JoinGuard(const JoinGuard &) = delete;
+            JoinGuard &operator=(const JoinGuard &) = delete;
+            ~JoinGuard()
+            {
+                for (std::thread &thread : threads)
+                {
+                    thread.join();
+                }
+            }
+        };
+
+        // Runs body(chunk) for every chunk in [0, count), chunk 0 on the calling thread.
+        // An exception from any chunk is rethrown on the calling thread once every worker
+        // has joined; when several chunks throw, the lowest chunk wins, as it would in a
+        // single-threaded loop.
+        template <typename Body>
+        void runChunks(unsigned count, const Body &body)
+        {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+            std::vector<std::exception_ptr> errors(count);
+            auto run = [&body, &errors](unsigned chunk)
+            {
+                try
+                {
+                    body(chunk);
+                }
+                catch (...)
+                {
+                    errors[chunk] = std::current_exception();
+                }
+            };
+#else
+            const Body &run = body;
+#endif
+            {
+                JoinGuard workers;
+                workers.threads.reserve(count - 1);
+                for (unsigned chunk = 1; chunk < count; ++chunk)
+                {
+                    workers.threads.emplace_back(std::cref(run), chunk);
+                }
+                run(0U);
+            }
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+            for (const std::exception_ptr &error : errors)
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+#endif
+        }
+    }
+}
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,157 @@
+#ifndef STATICFRACTION_HPP
+#define STATICFRACTION_HPP
+
+#include "Fraction.hpp"
+#include "Gcd.hpp"
+#include <cstdint>
+
+namespace ariel
+{
+    // Compile-time constant N/D, in the spirit of std::ratio, that mixes with runtime
+    // BasicFraction values. The constant is reduced at compile time, so the operators
+    // only cancel the runtime operand against it:
+    //   * by N/1 or 1/D   one gcd instead of two
+    //   * by 2^k          a trailing-zero count instead of a gcd
+    //   / by N/D          * by the reciprocal D/N
+    //   + and - by N/1    no gcd at all: gcd(a + N*b, b) == gcd(a, b) == 1
+    // Results and exceptions are the same as with the plain operators.
+    template <intmax_t N, intmax_t D = 1>
+    struct StaticFraction
+    {
+        static_assert(D != 0, "StaticFraction denominator cannot be zero");
+
+    private:
+        static constexpr uintmax_t GCD = euclidGcd(magnitude(N), magnitude(D));
+        static constexpr bool NEGATIVE = (N < 0) != (D < 0);
+
+    public:
+        static constexpr uintmax_t num_magnitude = magnitude(N) / GCD;
+        static constexpr intmax_t num = NEGATIVE ? -static_cast<intmax_t>(num_magnitude) : static_cast<intmax_t>(num_magnitude);
+        static constexpr intmax_t den = static_cast<intmax_t>(magnitude(D) / GCD);
+
+        using type = StaticFraction<num, den>;
+        using reciprocal = StaticFraction<den, num>;
+
+        template <typename Int>
+        static constexpr BasicFraction<Int> value()
+        {
+            static_assert(num_magnitude <= magnitude(FractionTraits<Int>::max()) && den <= FractionTraits<Int>::max(),
+                          "StaticFraction does not fit in this backend");
+            // Already reduced at compile time, so the fields are set without a gcd
+            return BasicFraction<Int>::fromReduced(ReducedKey(), static_cast<Int>(num), static_cast<Int>(den));
+        }
+
+        template <typename Int>
+        constexpr operator BasicFraction<Int>() const { return value<Int>(); }
+
+        template <typename Int>
+        friend constexpr BasicFraction<Int> operator*(const BasicFraction<Int> &frac, StaticFraction /*constant*/) { return scale<num, den>(frac, "operator*"); }
+        template <typename Int>
+        friend constexpr BasicFraction<Int> operator*(StaticFraction /*constant*/, const BasicFraction<Int> &frac) { return scale<num, den>(frac, "operator*"); }
+        template <typename Int>
+        friend constexpr BasicFraction<Int> operator/(const BasicFraction<Int> &frac, StaticFraction /*constant*/)
+        {
+            static_assert(N != 0, "Division by a zero StaticFraction");
+            return scale<NEGATIVE ? -den : den, static_cast<intmax_t>(num_magnitude)>(frac, "operator/");
+        }
+        template <typename Int>
+        friend constexpr BasicFraction<Int> operator/(StaticFraction /*constant*/, const BasicFraction<Int> &frac) { return value<Int>() / frac; }
+
+        template <typename Int>
+        friend constexpr BasicFraction<Int> operator+(const BasicFraction<Int> &frac, StaticFraction /*constant*/) { return shift(frac, false, "operator+"); }
+        template <typename Int>
+        friend constexpr BasicFraction<Int> operator+(StaticFraction /*constant*/, const BasicFraction<Int> &frac) { return shift(frac, false, "operator+"); }
+        template <typename Int>
+        friend constexpr BasicFraction<Int> operator-(const BasicFraction<Int> &frac, StaticFraction /*constant*/) { return shift(frac, true, "operator-"); }
+        template <typename Int>
+        friend constexpr BasicFraction<Int> operator-(StaticFraction /*constant*/, const BasicFraction<Int> &frac) { return value<Int>() - frac; }
+
+        template <typename Int>
+        friend constexpr bool operator==(const BasicFraction<Int> &frac, StaticFraction /*constant*/)
+        {
+            return frac.getNumerator() == num && frac.getDenominator() == den;
+        }
+
+    private:
+        // gcd(value, K) for a constant K and a non-zero value
+        template <typename Unsigned, uintmax_t K>
+        static constexpr Unsigned constantGcd(Unsigned value)
+        {
+            if constexpr (K == 1)
+            {
+                return 1;
+            }
+            else if constexpr ((K & (K - 1)) == 0)
+            {
+                constexpr int POWER = trailingZeros(K);
+                int zeros = trailingZeros(value);
+                return static_cast<Unsigned>(Unsigned(1) << (zeros < POWER ? zeros : POWER));
+            }
+            else
+            {
+                return kernelGcd(value, static_cast<Unsigned>(K));
+            }
+        }
+
+        // frac * SNum/SDen for a reduced constant with SDen > 0, cancelled across the fraction
+        // bar like BasicFraction::product
+        template <intmax_t SNum, intmax_t SDen, typename Int>
+        static constexpr BasicFraction<Int> scale(const BasicFraction<Int> &frac, const char *what)
+        {
+            using Unsigned = typename FractionTraits<Int>::unsigned_type;
+            constexpr uintmax_t SNUM_MAGNITUDE = magnitude(SNum);
+            static_assert(SNUM_MAGNITUDE <= magnitude(FractionTraits<Int>::max()) && SDen <= FractionTraits<Int>::max(),
+                          "StaticFraction does not fit in this backend");
+            if (frac.getNumerator() == 0 || SNum == 0)
+            {
+                return BasicFraction<Int>();
+            }
+            Unsigned frac_num = magnitude(frac.getNumerator());
+            auto frac_den = static_cast<Unsigned>(frac.getDenominator());
+            Unsigned cross_num = constantGcd<Unsigned, static_cast<uintmax_t>(SDen)>(frac_num);
+            Unsigned cross_den = constantGcd<Unsigned, SNUM_MAGNITUDE>(frac_den);
+            Checked<BasicFraction<Int>> result = BasicFraction<Int>::reducedProduct(
+                ReducedKey(), frac_num / cross_num, static_cast<Unsigned>(SNUM_MAGNITUDE) / cross_den, frac_den / cross_den, static_cast<Unsigned>(SDen) / cross_num,
+                (frac.getNumerator() < 0) != (SNum < 0));
+            if (!result)
+            {
+                raise(result.error(), what);
+            }
+            return *result;
+        }
+
+        // frac +- num/den; whole constants need no gcd since a/b + N is (a + N*b)/b
+        template <typename Int>
+        static constexpr BasicFraction<Int> shift(const BasicFraction<Int> &frac, bool subtract, const char *what)
+        {
+            Checked<BasicFraction<Int>> result = FractionError::Overflow;
+            if constexpr (den == 1)
+            {
+                // Exact in the wide type for int and int64_t, checked for __int128 like sum()
+                using Wide = typename FractionTraits<Int>::wide_type;
+                static_assert(num_magnitude <= magnitude(FractionTraits<Int>::max()), "StaticFraction does not fit in this backend");
+                Wide offset = 0;
+                Wide wide_num = 0;
+                Int numerator = 0;
+                if (!__builtin_mul_overflow(static_cast<Wide>(num), static_cast<Wide>(frac.getDenominator()), &offset) &&
+                    !(subtract ? __builtin_sub_overflow(static_cast<Wide>(frac.getNumerator()), offset, &wide_num)
+                               : __builtin_add_overflow(static_cast<Wide>(frac.getNumerator()), offset, &wide_num)) &&
+                    !__builtin_add_overflow(wide_num, Wide(0), &numerator))
+                {
+                    result = BasicFraction<Int>::fromReduced(ReducedKey(), numerator, frac.getDenominator());
+                }
+            }
+            else
+            {
+                result = subtract ? checkedSubtract(frac, value<Int>()) : checkedAdd(frac, value<Int>());
+            }
+            if (!result)
+            {
+                raise(result.error(), what);
+            }
+            return *result;
+        }
+    };
+}
+
+#endif // STATICFRACTION_HPP